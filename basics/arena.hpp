@@ -0,0 +1,57 @@
+/**
+ * arena
+ *
+ * Monotonic arena for per-request work: every std::pmr container built on it bump-allocates from one
+ * buffer, deallocation is a no-op, and reset() releases everything at once. The initial buffer is kept
+ * across resets, so a request that fits in it makes no heap allocation at all; bigger requests take more
+ * blocks from the upstream resource, given back on reset().
+ *
+ * Containers and strings allocated from an arena must not be used after its reset() or destruction.
+ *
+ * Usage:
+ *  arena::Arena arena;                    // 64 KB
+ *  for (const std::string_view line : lines) {
+ *      {
+ *          const auto fields = splitString(line, ',', arena.resource());
+ *          const std::pmr::string upper = toUpperCase(fields[0], arena.resource());
+ *          ...
+ *      }
+ *      arena.reset();                     // once fields and upper are destroyed
+ *  }
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+
+namespace arena {
+
+    class Arena {
+    public:
+        /**
+         * @param capacity size of the initial buffer, allocated once with new
+         * @param upstream where blocks beyond the initial buffer come from
+         */
+        explicit Arena(const std::size_t capacity = 64 * 1024,
+                       std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) :
+            buffer_(std::make_unique_for_overwrite<std::byte[]>(capacity)),
+            resource_(buffer_.get(), capacity, upstream) {}
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        // To pass to the std::pmr overloads, or to construct std::pmr containers
+        [[nodiscard]] auto resource() noexcept -> std::pmr::memory_resource * { return &resource_; }
+
+        // Release every allocation, the next one starts at the beginning of the initial buffer
+        void reset() { resource_.release(); }
+
+    private:
+        std::unique_ptr<std::byte[]> buffer_;
+        std::pmr::monotonic_buffer_resource resource_;
+    };
+
+}
@@ -0,0 +1,160 @@
+/**
+ * ascii
+ *
+ * ASCII-only case conversion without copies, allocations or locales: in place, or into a caller buffer.
+ * Bytes >= 0x80 are left alone, so UTF-8 input stays valid (non-ASCII letters are not converted, see casemap.hpp).
+ *
+ * Kernel: branchless range compare + xor, 32 bytes per step with AVX2 (16 with SSE2):
+ *   'A' <= c <= 'Z'  ⇔  (signed char)(c + 0x80 - 'A') < -128 + 26,  then  c ^= 0x20
+ * The last partial block is handled by an overlapping load, which is fine because the mapping is idempotent.
+ *
+ * Usage:
+ *  ascii::toLower(std::span<char>(header));            // in place
+ *  char key[64];  ascii::toLower(name, key);           // string_view → buffer, no allocation
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "simd.hpp"
+
+
+namespace ascii {
+
+    enum class Case : std::uint8_t {
+        lower,
+        upper,
+    };
+
+    namespace detail {
+
+        [[nodiscard]] constexpr auto mapScalar(const unsigned char c, const Case target) noexcept -> unsigned char {
+            const unsigned char first = target == Case::lower ? 'A' : 'a';
+            return static_cast<unsigned char>(c ^ (static_cast<unsigned char>(c - first) < 26 ? 0x20 : 0));
+        }
+
+        inline void mapScalar(const unsigned char *src, unsigned char *dst, const std::size_t size, const Case target) {
+            for (std::size_t i = 0; i < size; ++i) dst[i] = mapScalar(src[i], target);
+        }
+
+#if defined(GOTCHAS_HAS_SIMD)
+
+        GOTCHAS_TARGET("sse2")
+        inline auto mapBlockSSE2(const __m128i block, const Case target) -> __m128i {
+            const char first = target == Case::lower ? 'A' : 'a';
+            const __m128i shifted = _mm_add_epi8(block, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+            const __m128i inRange = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 26), shifted);
+            return _mm_xor_si128(block, _mm_and_si128(inRange, _mm_set1_epi8(0x20)));
+        }
+
+        GOTCHAS_TARGET("sse2")
+        inline void mapSSE2(const unsigned char *src, unsigned char *dst, const std::size_t size, const Case target) {
+            if (size < 16) return mapScalar(src, dst, size, target);
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), mapBlockSSE2(block, target));
+            }
+            if (i < size) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + size - 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + size - 16), mapBlockSSE2(block, target));
+            }
+        }
+
+        GOTCHAS_TARGET("avx2")
+        inline auto mapBlockAVX2(const __m256i block, const Case target) -> __m256i {
+            const char first = target == Case::lower ? 'A' : 'a';
+            const __m256i shifted = _mm256_add_epi8(block, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+            const __m256i inRange = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+            return _mm256_xor_si256(block, _mm256_and_si256(inRange, _mm256_set1_epi8(0x20)));
+        }
+
+        GOTCHAS_TARGET("avx2")
+        inline void mapAVX2(const unsigned char *src, unsigned char *dst, const std::size_t size, const Case target) {
+            if (size < 32) return mapSSE2(src, dst, size, target);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), mapBlockAVX2(block, target));
+            }
+            if (i < size) {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + size - 32));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + size - 32), mapBlockAVX2(block, target));
+            }
+        }
+
+        GOTCHAS_TARGET("avx2")
+        inline auto prefixLengthAVX2(const unsigned char *p, const std::size_t size) -> std::size_t {
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(block));
+                if (mask) return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+            while (i < size && p[i] < 0x80) ++i;
+            return i;
+        }
+
+#endif
+
+    }
+
+    /**
+     * Map `size` bytes from `src` to `dst`. Same pointer for in place; otherwise the ranges must not overlap.
+     */
+    inline void map(const char *src, char *dst, const std::size_t size, const Case target) noexcept {
+        const auto *from = reinterpret_cast<const unsigned char *>(src);
+        auto *to = reinterpret_cast<unsigned char *>(dst);
+#if defined(GOTCHAS_HAS_SIMD)
+        switch (simd::level()) {
+            case simd::Level::avx2: return detail::mapAVX2(from, to, size, target);
+            case simd::Level::sse2: return detail::mapSSE2(from, to, size, target);
+            default: break;
+        }
+#endif
+        detail::mapScalar(from, to, size, target);
+    }
+
+    // Number of leading ASCII bytes
+    [[nodiscard]] inline auto prefixLength(const std::string_view &str) noexcept -> std::size_t {
+        const auto *p = reinterpret_cast<const unsigned char *>(str.data());
+#if defined(GOTCHAS_HAS_SIMD)
+        if (simd::level() == simd::Level::avx2) return detail::prefixLengthAVX2(p, str.size());
+#endif
+        std::size_t i = 0;
+        while (i < str.size() && p[i] < 0x80) ++i;
+        return i;
+    }
+
+    inline void toLower(const std::span<char> str) noexcept {
+        map(str.data(), str.data(), str.size(), Case::lower);
+    }
+
+    inline void toUpper(const std::span<char> str) noexcept {
+        map(str.data(), str.data(), str.size(), Case::upper);
+    }
+
+    /**
+     * Convert into a caller buffer.
+     *
+     * @param str input
+     * @param out destination, at least str.size() bytes
+     * @return number of bytes written, 0 if `out` is too small
+     */
+    inline auto toLower(const std::string_view &str, const std::span<char> out) noexcept -> std::size_t {
+        if (out.size() < str.size()) return 0;
+        map(str.data(), out.data(), str.size(), Case::lower);
+        return str.size();
+    }
+
+    inline auto toUpper(const std::string_view &str, const std::span<char> out) noexcept -> std::size_t {
+        if (out.size() < str.size()) return 0;
+        map(str.data(), out.data(), str.size(), Case::upper);
+        return str.size();
+    }
+
+}
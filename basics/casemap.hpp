@@ -0,0 +1,197 @@
+/**
+ * casemap
+ *
+ * Locale-independent full Unicode case mapping (upper, lower, title, fold) straight on UTF-8 bytes.
+ *
+ * Unlike std::toupper(wchar_t, std::locale), mappings may expand to several code points:
+ *   "Straße" → upper "STRASSE", fold "strasse";  "ŉ" → "ʼN";  "ǆ" → title "ǅ"
+ *
+ * Data: casemap_tables.hpp, generated by gen_casemap.py. Two-stage lookup: code point >> 7 selects one of the
+ * unique 128-entry blocks, the block entry is an index into a small table of (delta | special) records.
+ *
+ * Fast paths: runs of ASCII go through the ascii.hpp SIMD kernel, 2-byte sequences (Latin-1, Latin Extended, Greek,
+ * Cyrillic, Armenian, Hebrew...) are decoded inline, everything else via utf8::decodeNext.
+ * Ill-formed input is replaced with U+FFFD.
+ *
+ * Context-sensitive rules: Final_Sigma (Σ → ς at the end of a word) for lower;
+ * title case maps the first cased letter of a word to title case and the rest to lower case.
+ * Language-specific rules (Turkish dotless i, Lithuanian) are not applied.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "ascii.hpp"
+#include "casemap_tables.hpp"
+#include "utf8.hpp"
+
+
+namespace casemap {
+
+    enum class Mapping : std::uint8_t {
+        upper = 0,
+        lower = 1,
+        title = 2,
+        fold = 3,
+    };
+
+    [[nodiscard]] inline auto record(const char32_t cp) noexcept -> const tables::Record & {
+        if (cp >= tables::limit) {
+            return tables::records[0]; // identity, not cased
+        }
+        constexpr char32_t mask = (1u << tables::shift) - 1;
+        return tables::records[tables::stage2[(tables::stage1[cp >> tables::shift] << tables::shift) | (cp & mask)]];
+    }
+
+    [[nodiscard]] inline auto isCased(const char32_t cp) noexcept -> bool {
+        return record(cp).flags & tables::cased;
+    }
+
+    [[nodiscard]] inline auto isCaseIgnorable(const char32_t cp) noexcept -> bool {
+        return record(cp).flags & tables::caseIgnorable;
+    }
+
+    // Full mapping of a single code point: 1 to 3 code points
+    struct Mapped {
+        std::array<char32_t, 3> codePoints;
+        std::uint8_t size;
+    };
+
+    [[nodiscard]] inline auto map(const char32_t cp, const Mapping mapping) noexcept -> Mapped {
+        const auto index = static_cast<unsigned>(mapping);
+        const tables::Record &rec = record(cp);
+        const std::int32_t value = rec.mapping[index];
+        if (rec.flags & (tables::special << index)) {
+            const char32_t *expansion = tables::specialPool + (value >> 2);
+            const auto size = static_cast<std::uint8_t>(value & 3);
+            return {{expansion[0], size > 1 ? expansion[1] : 0, size > 2 ? expansion[2] : 0}, size};
+        }
+        return {{static_cast<char32_t>(static_cast<std::int32_t>(cp) + value), 0, 0}, 1};
+    }
+
+
+    namespace detail {
+
+        // Decode with an inline shortcut for 2-byte sequences
+        [[nodiscard]] inline auto decode(const unsigned char *p, const unsigned char *end) noexcept -> utf8::Sequence {
+            if (p[0] >= 0xC2 && p[0] < 0xE0 && end - p >= 2 && utf8::isContinuation(p[1])) {
+                return {static_cast<char32_t>(((p[0] & 0x1F) << 6) | (p[1] & 0x3F)), 2, utf8::Status::ok};
+            }
+            return utf8::decodeNext(p, end);
+        }
+
+        // Final_Sigma: is the next non case-ignorable code point cased?
+        [[nodiscard]] inline auto followedByCased(const unsigned char *p, const unsigned char *end) noexcept -> bool {
+            while (p < end) {
+                const utf8::Sequence seq = decode(p, end);
+                const std::uint8_t flags = record(seq.codePoint).flags;
+                if (!(flags & tables::caseIgnorable)) {
+                    return flags & tables::cased;
+                }
+                p += seq.length;
+            }
+            return false;
+        }
+
+    }
+
+
+    /**
+     * Append the case-mapped `str` to `out`.
+     *
+     * @param out destination, existing content is kept; std::string or std::pmr::string
+     * @param str UTF-8 input
+     * @param mapping upper, lower, title or fold
+     */
+    template<typename Allocator>
+    void append(std::basic_string<char, std::char_traits<char>, Allocator> &out, const std::string_view &str,
+                const Mapping mapping) {
+        const unsigned char *p = utf8::bytes(str);
+        const unsigned char *end = p + str.size();
+
+        // Preceded by a cased letter (skipping case-ignorable ones): title case and Final_Sigma state
+        bool afterCased = false;
+
+        out.reserve(out.size() + str.size());
+
+        while (p < end) {
+            if (*p < 0x80 && mapping != Mapping::title) {
+                // ASCII run: SIMD range compare + xor, no decoding
+                const unsigned char *run = p;
+                p += ascii::prefixLength({reinterpret_cast<const char *>(p), static_cast<std::size_t>(end - p)});
+                const std::size_t offset = out.size();
+                out.resize(offset + static_cast<std::size_t>(p - run));
+                ascii::map(reinterpret_cast<const char *>(run), out.data() + offset, static_cast<std::size_t>(p - run),
+                           mapping == Mapping::upper ? ascii::Case::upper : ascii::Case::lower);
+
+                if (mapping == Mapping::lower) {
+                    // Final_Sigma state from the last ASCII character that is not case-ignorable (' . : ^ `)
+                    for (const unsigned char *q = p; q > run; --q) {
+                        const std::uint8_t flags = record(q[-1]).flags;
+                        if (!(flags & tables::caseIgnorable)) {
+                            afterCased = flags & tables::cased;
+                            break;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            const utf8::Sequence seq = detail::decode(p, end);
+            const char32_t cp = seq.codePoint;
+            const tables::Record &rec = record(cp);
+
+            Mapping effective = mapping;
+            if (mapping == Mapping::title) {
+                effective = afterCased ? Mapping::lower : Mapping::title;
+            }
+
+            if (cp == 0x03A3 && effective == Mapping::lower && afterCased &&
+                !detail::followedByCased(p + seq.length, end)) {
+                utf8::append(out, 0x03C2); // ς
+            } else {
+                const auto index = static_cast<unsigned>(effective);
+                const std::int32_t value = rec.mapping[index];
+                if (rec.flags & (tables::special << index)) {
+                    const char32_t *expansion = tables::specialPool + (value >> 2);
+                    for (std::int32_t i = 0; i < (value & 3); ++i) utf8::append(out, expansion[i]);
+                } else {
+                    utf8::append(out, static_cast<char32_t>(static_cast<std::int32_t>(cp) + value));
+                }
+            }
+
+            if (!(rec.flags & tables::caseIgnorable)) {
+                afterCased = rec.flags & tables::cased;
+            }
+            p += seq.length;
+        }
+    }
+
+    [[nodiscard]] inline auto transform(const std::string_view &str, const Mapping mapping) -> std::string {
+        std::string result;
+        append(result, str, mapping);
+        return result;
+    }
+
+    [[nodiscard]] inline auto toUpper(const std::string_view &str) -> std::string {
+        return transform(str, Mapping::upper);
+    }
+
+    [[nodiscard]] inline auto toLower(const std::string_view &str) -> std::string {
+        return transform(str, Mapping::lower);
+    }
+
+    [[nodiscard]] inline auto toTitle(const std::string_view &str) -> std::string {
+        return transform(str, Mapping::title);
+    }
+
+    // Case folding for caseless comparison: fold(a) == fold(b)
+    [[nodiscard]] inline auto fold(const std::string_view &str) -> std::string {
+        return transform(str, Mapping::fold);
+    }
+
+}
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+Generate casemap_tables.hpp: two-stage lookup tables for full Unicode case mappings.
+
+Python's str.upper() / lower() / title() / casefold() are built from UnicodeData.txt, SpecialCasing.txt
+(unconditional mappings) and CaseFolding.txt (C + F), so the data matches unicodedata.unidata_version.
+Use a newer Python to pick up a newer Unicode version.
+
+Usage:
+    python3 gen_casemap.py > casemap_tables.hpp
+"""
+
+import sys
+import unicodedata
+
+SHIFT = 7  # 128 code points per block
+BLOCK = 1 << SHIFT
+
+MAPPINGS = (str.upper, str.lower, str.title, str.casefold)
+
+CASED = 1
+CASE_IGNORABLE = 2
+SPECIAL = 4  # SPECIAL << mapping index: the mapping expands to several code points
+
+# Word_Break MidLetter / MidNumLet / Single_Quote, the non-category part of Case_Ignorable
+CASE_IGNORABLE_EXTRA = {0x0027, 0x002E, 0x003A, 0x00B7, 0x0387, 0x055F, 0x05F4, 0x2018, 0x2019, 0x2024, 0x2027,
+                        0xFE13, 0xFE52, 0xFE55, 0xFF07, 0xFF0E, 0xFF1A}
+
+
+def records_for(cp, special_pool, special_index):
+    ch = chr(cp)
+    flags = 0
+    category = unicodedata.category(ch)
+    if category in ('Lu', 'Ll', 'Lt') or ch.lower() != ch or ch.upper() != ch:
+        flags |= CASED
+    if category in ('Mn', 'Me', 'Cf', 'Lm', 'Sk') or cp in CASE_IGNORABLE_EXTRA:
+        flags |= CASE_IGNORABLE
+
+    values = []
+    for i, f in enumerate(MAPPINGS):
+        mapped = f(ch)
+        if len(mapped) == 1:
+            values.append(ord(mapped) - cp)
+        else:
+            assert 1 < len(mapped) <= 3
+            key = tuple(ord(c) for c in mapped)
+            if key not in special_index:
+                special_index[key] = len(special_pool)
+                special_pool.extend(key)
+            values.append((special_index[key] << 2) | len(key))
+            flags |= SPECIAL << i
+    return tuple(values) + (flags,)
+
+
+def main():
+    special_pool = []
+    special_index = {}
+
+    limit = 0
+    for cp in range(0x110000):
+        if 0xD800 <= cp < 0xE000:
+            continue
+        ch = chr(cp)
+        if any(f(ch) != ch for f in MAPPINGS):
+            limit = cp + 1
+    limit = (limit + BLOCK - 1) // BLOCK * BLOCK
+
+    records = [(0, 0, 0, 0, 0)]
+    record_index = {records[0]: 0}
+    blocks = []
+    block_index = {}
+    stage1 = []
+
+    for start in range(0, limit, BLOCK):
+        block = []
+        for cp in range(start, start + BLOCK):
+            rec = (0, 0, 0, 0, 0) if 0xD800 <= cp < 0xE000 else records_for(cp, special_pool, special_index)
+            if rec not in record_index:
+                record_index[rec] = len(records)
+                records.append(rec)
+            block.append(record_index[rec])
+        block = tuple(block)
+        if block not in block_index:
+            block_index[block] = len(blocks)
+            blocks.append(block)
+        stage1.append(block_index[block])
+
+    assert len(blocks) <= 256, 'stage1 no longer fits into uint8_t'
+    assert len(records) <= 65536
+
+    out = sys.stdout
+    out.write('// Generated by gen_casemap.py from Unicode %s data, do not edit.\n' % unicodedata.unidata_version)
+    out.write('// %d records, %d unique blocks of %d, %d special code points\n\n'
+              % (len(records), len(blocks), BLOCK, len(special_pool)))
+    out.write('#pragma once\n\n#include <cstdint>\n\n\nnamespace casemap::tables {\n\n')
+    out.write('    inline constexpr const char *unicodeVersion = "%s";\n\n' % unicodedata.unidata_version)
+    out.write('    inline constexpr std::uint32_t shift = %d;\n' % SHIFT)
+    out.write('    inline constexpr char32_t limit = 0x%X;\n\n' % limit)
+
+    out.write('    // Mapping deltas (upper, lower, title, fold) or (pool offset << 2 | length) when the SPECIAL flag is set\n')
+    out.write('    struct Record {\n        std::int32_t mapping[4];\n        std::uint8_t flags;\n    };\n\n')
+    out.write('    inline constexpr std::uint8_t cased = %d;\n' % CASED)
+    out.write('    inline constexpr std::uint8_t caseIgnorable = %d;\n' % CASE_IGNORABLE)
+    out.write('    inline constexpr std::uint8_t special = %d; // << mapping index\n\n' % SPECIAL)
+
+    out.write('    inline constexpr Record records[%d] = {\n' % len(records))
+    for rec in records:
+        out.write('        {{%d, %d, %d, %d}, %d},\n' % rec)
+    out.write('    };\n\n')
+
+    out.write('    inline constexpr char32_t specialPool[%d] = {\n' % max(1, len(special_pool)))
+    for i in range(0, len(special_pool), 8):
+        out.write('        ' + ' '.join('0x%04X,' % c for c in special_pool[i:i + 8]) + '\n')
+    out.write('    };\n\n')
+
+    out.write('    inline constexpr std::uint8_t stage1[%d] = {\n' % len(stage1))
+    for i in range(0, len(stage1), 16):
+        out.write('        ' + ' '.join('%d,' % b for b in stage1[i:i + 16]) + '\n')
+    out.write('    };\n\n')
+
+    out.write('    inline constexpr std::uint16_t stage2[%d] = {\n' % (len(blocks) * BLOCK))
+    for block in blocks:
+        for i in range(0, BLOCK, 16):
+            out.write('        ' + ' '.join('%d,' % r for r in block[i:i + 16]) + '\n')
+    out.write('    };\n\n}\n')
+
+
+if __name__ == '__main__':
+    main()
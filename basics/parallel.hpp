@@ -0,0 +1,430 @@
+/**
+ * parallel
+ *
+ * Multithreaded versions of the strings.hpp helpers for very large inputs (hundreds of MB and up).
+ *
+ * The input is cut into chunks of about `chunkSize` bytes at boundaries where the serial algorithm doesn't
+ * carry any state across, each chunk is processed as a task on a work-stealing thread pool, and the outputs
+ * are stitched back in order. Results are identical to the serial versions:
+ *
+ *  - case mapping: cut right after an ASCII byte that is neither cased nor case-ignorable (space, digit, ',' ...),
+ *    so title case and Final_Sigma see the same context on both sides
+ *  - code points: cut before any non-continuation byte, which always starts a new (maximal subpart) sequence
+ *  - delimiters: cut at a delimiter match that no other match overlaps, so it is one the serial scan finds too
+ *
+ * When no such boundary exists (a gigabyte of CJK without a single space), the chunk simply grows.
+ * Inputs shorter than two chunks run serially on the calling thread.
+ *
+ * Usage:
+ *  parallel::toUpperCase(blob);
+ *  parallel::ThreadPool pool(4);  parallel::splitString(blob, '\n', pool);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "strings.hpp"
+
+
+namespace parallel {
+
+    /**
+     * Thread pool with one task deque per worker: owners pop from the back, idle workers steal from the front.
+     * run() blocks, and the calling thread works on the batch too, so nested run() calls don't deadlock.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @param concurrency total number of threads working on a batch, including the caller of run()
+         */
+        explicit ThreadPool(const std::size_t concurrency = std::max(1u, std::thread::hardware_concurrency())) :
+            queues_(std::max<std::size_t>(concurrency, 1)) {
+            for (std::size_t i = 1; i < queues_.size(); ++i) {
+                workers_.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(sleepMutex_);
+                stop_ = true;
+            }
+            wakeUp_.notify_all();
+            for (std::thread &worker : workers_) worker.join();
+        }
+
+        [[nodiscard]] auto concurrency() const noexcept -> std::size_t { return queues_.size(); }
+
+        // Process-wide pool with one thread per hardware thread
+        [[nodiscard]] static auto shared() -> ThreadPool & {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        /**
+         * Call fn(0) ... fn(tasks - 1) and wait for all of them.
+         * The first exception thrown by a task is rethrown here, after the remaining tasks are finished.
+         */
+        void run(const std::size_t tasks, const std::function<void(std::size_t)> &fn) {
+            if (tasks == 0) return;
+
+            Batch batch{fn, tasks};
+            for (std::size_t i = 0; i < tasks; ++i) {
+                Queue &queue = queues_[i % queues_.size()];
+                std::lock_guard lock(queue.mutex);
+                queue.tasks.push_back({&batch, i});
+            }
+            queued_.fetch_add(tasks);
+            {
+                std::lock_guard lock(sleepMutex_);
+            }
+            wakeUp_.notify_all();
+
+            // Help out until nothing is left to take, then wait for tasks still running elsewhere
+            while (const std::optional<Task> task = take(0)) {
+                execute(*task);
+            }
+            {
+                std::unique_lock lock(batch.mutex);
+                batch.done.wait(lock, [&] { return batch.remaining == 0; });
+            }
+
+            if (batch.error) std::rethrow_exception(batch.error);
+        }
+
+    private:
+        struct Batch {
+            const std::function<void(std::size_t)> &fn;
+            std::size_t remaining;
+            std::mutex mutex{};
+            std::condition_variable done{};
+            std::exception_ptr error{};
+        };
+
+        struct Task {
+            Batch *batch;
+            std::size_t index;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        // Own queue first (newest task, still warm in cache), then steal the oldest task of the others
+        auto take(const std::size_t self) -> std::optional<Task> {
+            for (std::size_t i = 0; i < queues_.size(); ++i) {
+                Queue &queue = queues_[(self + i) % queues_.size()];
+                std::lock_guard lock(queue.mutex);
+                if (queue.tasks.empty()) continue;
+                Task task;
+                if (i == 0) {
+                    task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                } else {
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+                queued_.fetch_sub(1);
+                return task;
+            }
+            return std::nullopt;
+        }
+
+        static void execute(const Task &task) {
+            Batch &batch = *task.batch;
+            std::exception_ptr error;
+            try {
+                batch.fn(task.index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            // Notify under the lock: the batch lives on the stack of run() and is gone right after
+            std::lock_guard lock(batch.mutex);
+            if (error && !batch.error) batch.error = error;
+            if (--batch.remaining == 0) batch.done.notify_all();
+        }
+
+        void work(const std::size_t self) {
+            while (true) {
+                if (const std::optional<Task> task = take(self)) {
+                    execute(*task);
+                    continue;
+                }
+                std::unique_lock lock(sleepMutex_);
+                wakeUp_.wait(lock, [this] { return stop_ || queued_.load() != 0; });
+                if (stop_ && queued_.load() == 0) return;
+            }
+        }
+
+        std::vector<Queue> queues_; // queues_[0] belongs to the thread calling run()
+        std::vector<std::thread> workers_;
+        std::atomic<std::size_t> queued_ = 0;
+        std::mutex sleepMutex_;
+        std::condition_variable wakeUp_;
+        bool stop_ = false;
+    };
+
+
+    inline constexpr std::size_t defaultChunkSize = 1 << 20;
+
+
+    namespace detail {
+
+        /**
+         * Chunk boundaries: 0 = b[0] < b[1] < ... < b[n] = size.
+         *
+         * @param cutAt finds the first acceptable boundary at or after a position, or npos
+         */
+        template<typename CutAt>
+        [[nodiscard]] auto boundaries(const std::size_t size, const std::size_t chunkSize, CutAt cutAt)
+            -> std::vector<std::size_t> {
+            std::vector<std::size_t> result{0};
+            const std::size_t step = std::max<std::size_t>(chunkSize, 1);
+            while (size - result.back() > step) {
+                const std::size_t cut = cutAt(result.back() + step);
+                if (cut == std::string_view::npos || cut >= size) break;
+                result.push_back(cut);
+            }
+            result.push_back(size);
+            return result;
+        }
+
+        // Byte that resets the case mapping context: ASCII, not cased, not case-ignorable
+        [[nodiscard]] inline auto isCaseBoundary(const unsigned char byte) noexcept -> bool {
+            return byte < 0x80 && !(casemap::record(byte).flags & (casemap::tables::cased | casemap::tables::caseIgnorable));
+        }
+
+        [[nodiscard]] inline auto caseBoundaries(const std::string_view &str, const std::size_t chunkSize)
+            -> std::vector<std::size_t> {
+            const unsigned char *bytes = utf8::bytes(str);
+            return boundaries(str.size(), chunkSize, [&](std::size_t pos) {
+                for (; pos < str.size(); ++pos) {
+                    if (isCaseBoundary(bytes[pos - 1])) return pos;
+                }
+                return std::string_view::npos;
+            });
+        }
+
+        [[nodiscard]] inline auto codePointBoundaries(const std::string_view &str, const std::size_t chunkSize)
+            -> std::vector<std::size_t> {
+            const unsigned char *bytes = utf8::bytes(str);
+            return boundaries(str.size(), chunkSize, [&](std::size_t pos) {
+                for (; pos < str.size(); ++pos) {
+                    if (!utf8::isContinuation(bytes[pos])) return pos;
+                }
+                return std::string_view::npos;
+            });
+        }
+
+        // Boundaries are delimiter positions, chunk i starts after the delimiter at b[i]
+        [[nodiscard]] inline auto delimiterBoundaries(const std::string_view &str, const split::Splitter &splitter,
+                                                      const std::size_t chunkSize) -> std::vector<std::size_t> {
+            const std::size_t length = splitter.delimiterLength();
+            std::size_t previousEnd = 0;
+            auto result = boundaries(str.size(), chunkSize, [&](std::size_t pos) {
+                pos = std::max(pos, previousEnd);
+                while ((pos = splitter.find(str, pos)) != std::string_view::npos) {
+                    // A match overlapping ours could be the one the serial scan picks instead
+                    bool isolated = true;
+                    for (std::size_t i = pos >= length - 1 ? pos - (length - 1) : 0; i < pos && isolated; ++i) {
+                        isolated = str.compare(i, length, str, pos, length) != 0;
+                    }
+                    if (isolated) {
+                        previousEnd = pos + length;
+                        return pos;
+                    }
+                    ++pos;
+                }
+                return std::string_view::npos;
+            });
+            return result;
+        }
+
+        // Concatenate per-chunk results in order, copying in parallel
+        [[nodiscard]] inline auto join(const std::vector<std::string> &parts, ThreadPool &pool) -> std::string {
+            std::vector<std::size_t> offsets(parts.size() + 1, 0);
+            for (std::size_t i = 0; i < parts.size(); ++i) offsets[i + 1] = offsets[i] + parts[i].size();
+
+            std::string result;
+            // The size argument is not used: libstdc++ 12 passes the grown capacity there
+            result.resize_and_overwrite(offsets.back(), [&](char *data, std::size_t) {
+                pool.run(parts.size(), [&](const std::size_t i) {
+                    std::memcpy(data + offsets[i], parts[i].data(), parts[i].size());
+                });
+                return offsets.back();
+            });
+            return result;
+        }
+
+        template<typename T>
+        [[nodiscard]] auto join(std::vector<std::vector<T>> &parts, ThreadPool &pool) -> std::vector<T> {
+            std::vector<std::size_t> offsets(parts.size() + 1, 0);
+            for (std::size_t i = 0; i < parts.size(); ++i) offsets[i + 1] = offsets[i] + parts[i].size();
+
+            std::vector<T> result(offsets.back());
+            pool.run(parts.size(), [&](const std::size_t i) {
+                std::ranges::copy(parts[i], result.begin() + static_cast<std::ptrdiff_t>(offsets[i]));
+                std::vector<T>().swap(parts[i]); // free early
+            });
+            return result;
+        }
+
+    }
+
+
+    /**
+     * Case-map a large UTF-8 string on all cores.
+     *
+     * @param str UTF-8 input, ill-formed sequences become U+FFFD
+     * @param mapping upper, lower, title or fold
+     * @param pool threads to use
+     * @param chunkSize approximate bytes per task
+     * @return the same bytes as casemap::transform(str, mapping)
+     */
+    [[nodiscard]] inline auto transform(const std::string_view &str, const casemap::Mapping mapping,
+                                        ThreadPool &pool = ThreadPool::shared(),
+                                        const std::size_t chunkSize = defaultChunkSize) -> std::string {
+        const std::vector<std::size_t> cuts = detail::caseBoundaries(str, chunkSize);
+        if (cuts.size() <= 2) return casemap::transform(str, mapping);
+
+        std::vector<std::string> parts(cuts.size() - 1);
+        pool.run(parts.size(), [&](const std::size_t i) {
+            parts[i] = casemap::transform(str.substr(cuts[i], cuts[i + 1] - cuts[i]), mapping);
+        });
+        return detail::join(parts, pool);
+    }
+
+    [[nodiscard]] inline auto toUpperCase(const std::string_view &str, ThreadPool &pool = ThreadPool::shared(),
+                                          const std::size_t chunkSize = defaultChunkSize) -> std::string {
+        return transform(str, casemap::Mapping::upper, pool, chunkSize);
+    }
+
+    [[nodiscard]] inline auto toLowerCase(const std::string_view &str, ThreadPool &pool = ThreadPool::shared(),
+                                          const std::size_t chunkSize = defaultChunkSize) -> std::string {
+        return transform(str, casemap::Mapping::lower, pool, chunkSize);
+    }
+
+    [[nodiscard]] inline auto toTitleCase(const std::string_view &str, ThreadPool &pool = ThreadPool::shared(),
+                                          const std::size_t chunkSize = defaultChunkSize) -> std::string {
+        return transform(str, casemap::Mapping::title, pool, chunkSize);
+    }
+
+    [[nodiscard]] inline auto foldCase(const std::string_view &str, ThreadPool &pool = ThreadPool::shared(),
+                                       const std::size_t chunkSize = defaultChunkSize) -> std::string {
+        return transform(str, casemap::Mapping::fold, pool, chunkSize);
+    }
+
+
+    /**
+     * Parallel ::splitIntoCodePoints(str, error): the valid prefix, and the first error with its offset in `str`.
+     */
+    [[nodiscard]] inline auto splitIntoCodePoints(const std::string_view &str, utf8::Error &error,
+                                                  ThreadPool &pool = ThreadPool::shared(),
+                                                  const std::size_t chunkSize = defaultChunkSize)
+        -> std::vector<std::string_view> {
+        const std::vector<std::size_t> cuts = detail::codePointBoundaries(str, chunkSize);
+        if (cuts.size() <= 2) return ::splitIntoCodePoints(str, error);
+
+        std::vector<std::vector<std::string_view>> parts(cuts.size() - 1);
+        std::vector<utf8::Error> errors(parts.size());
+        pool.run(parts.size(), [&](const std::size_t i) {
+            parts[i] = ::splitIntoCodePoints(str.substr(cuts[i], cuts[i + 1] - cuts[i]), errors[i]);
+        });
+
+        // Everything after the first broken chunk is dropped, like the serial version stops there
+        error = {};
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            if (!errors[i].ok()) {
+                // The next chunk starts with a non-continuation byte: cut short, not the end of input
+                const bool last = i + 1 == parts.size();
+                const utf8::Status status =
+                    errors[i].status == utf8::Status::truncated && !last ? utf8::Status::tooShort : errors[i].status;
+                error = {status, cuts[i] + errors[i].offset};
+                parts.resize(i + 1);
+                break;
+            }
+        }
+        return detail::join(parts, pool);
+    }
+
+    /**
+     * Throwing version.
+     *
+     * @throws utf8::DecodeError on malformed input, with the same offset as the serial version
+     */
+    [[nodiscard]] inline auto splitIntoCodePoints(const std::string_view &str, ThreadPool &pool = ThreadPool::shared(),
+                                                  const std::size_t chunkSize = defaultChunkSize)
+        -> std::vector<std::string_view> {
+        utf8::Error error;
+        auto codePoints = splitIntoCodePoints(str, error, pool, chunkSize);
+        if (!error.ok()) {
+            throw utf8::DecodeError(error);
+        }
+        return codePoints;
+    }
+
+
+    /**
+     * Parallel ::splitString() with a delimiter.
+     */
+    [[nodiscard]] inline auto splitString(const std::string_view &str, const split::Splitter &splitter,
+                                          ThreadPool &pool = ThreadPool::shared(),
+                                          const std::size_t chunkSize = defaultChunkSize)
+        -> std::vector<std::string_view> {
+        const std::vector<std::size_t> cuts = detail::delimiterBoundaries(str, splitter, chunkSize);
+        const std::size_t length = splitter.delimiterLength();
+
+        std::vector<std::vector<std::string_view>> parts(cuts.size() - 1);
+        pool.run(parts.size(), [&](const std::size_t i) {
+            const std::size_t start = i == 0 ? 0 : cuts[i] + length;
+            splitter.splitInto(str.substr(start, cuts[i + 1] - start), parts[i]);
+        });
+        return parts.size() == 1 ? std::move(parts[0]) : detail::join(parts, pool);
+    }
+
+    [[nodiscard]] inline auto splitString(const std::string_view &str, const char delimiter,
+                                          ThreadPool &pool = ThreadPool::shared(),
+                                          const std::size_t chunkSize = defaultChunkSize)
+        -> std::vector<std::string_view> {
+        return splitString(str, split::Splitter(delimiter), pool, chunkSize);
+    }
+
+    /**
+     * Parallel ::splitString(), empty delimiter splits into code points (lenient).
+     */
+    [[nodiscard]] inline auto splitString(const std::string_view &str, const std::string &delimiter,
+                                          ThreadPool &pool = ThreadPool::shared(),
+                                          const std::size_t chunkSize = defaultChunkSize)
+        -> std::vector<std::string_view> {
+        if (!delimiter.empty()) {
+            return splitString(str, split::Splitter(delimiter), pool, chunkSize);
+        }
+
+        const std::vector<std::size_t> cuts = detail::codePointBoundaries(str, chunkSize);
+        std::vector<std::vector<std::string_view>> parts(cuts.size() - 1);
+        pool.run(parts.size(), [&](const std::size_t i) {
+            parts[i] = ::splitString(str.substr(cuts[i], cuts[i + 1] - cuts[i]));
+        });
+        return parts.size() == 1 ? std::move(parts[0]) : detail::join(parts, pool);
+    }
+
+}
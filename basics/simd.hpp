@@ -0,0 +1,75 @@
+/**
+ * simd
+ *
+ * Runtime CPU feature detection for hand-vectorized kernels.
+ *
+ * Kernels are compiled with per-function target attributes, so the whole program can still be built
+ * for baseline x86-64 (no -mavx2 needed) and the best implementation is picked once at runtime.
+ *
+ * Set SIMD_LEVEL=scalar|sse2|avx2 in the environment to cap the detected level
+ * (handy for benchmarking the fallbacks on a modern CPU).
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GOTCHAS_X86_64 1
+#include <immintrin.h>
+#endif
+
+#if defined(GOTCHAS_X86_64) && (defined(__GNUC__) || defined(__clang__))
+// Compile a single function for a specific instruction set
+#define GOTCHAS_TARGET(isa) __attribute__((target(isa)))
+#define GOTCHAS_HAS_SIMD 1
+#else
+#define GOTCHAS_TARGET(isa)
+#endif
+
+
+namespace simd {
+
+    enum class Level {
+        scalar = 0,
+        sse2 = 1,
+        avx2 = 2,
+    };
+
+    [[nodiscard]] inline auto name(const Level level) -> std::string_view {
+        switch (level) {
+            case Level::avx2: return "avx2";
+            case Level::sse2: return "sse2";
+            default: return "scalar";
+        }
+    }
+
+    [[nodiscard]] inline auto detect() -> Level {
+        Level detected = Level::scalar;
+#if defined(GOTCHAS_HAS_SIMD)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")) {
+            detected = Level::avx2;
+        } else if (__builtin_cpu_supports("sse2")) {
+            detected = Level::sse2;
+        }
+#endif
+        // Optional cap from the environment, never raises the level above what CPU supports
+        if (const char *env = std::getenv("SIMD_LEVEL")) {
+            const std::string_view cap = env;
+            Level capped = detected;
+            if (cap == "scalar") capped = Level::scalar;
+            else if (cap == "sse2") capped = Level::sse2;
+            if (capped < detected) detected = capped;
+        }
+        return detected;
+    }
+
+    // Detected once, thread-safe since C++11 (magic statics)
+    [[nodiscard]] inline auto level() -> Level {
+        static const Level cached = detect();
+        return cached;
+    }
+
+}
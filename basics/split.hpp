@@ -0,0 +1,468 @@
+/**
+ * split
+ *
+ * Delimiter splitting with the delimiter preprocessed once, for CSV/TSV-sized inputs.
+ *
+ *  split::Splitter comma(',');                  // single byte: one vector compare per 32 bytes
+ *  split::Splitter::anyOf(",;\t");              // byte set: AVX2 nibble-table lookup (shufti), up to 8 distinct
+ *                                               //   high nibbles, otherwise a 256-bit bitmap
+ *  split::Splitter scope("::");                 // multi-byte: first/last byte vector filter + memcmp,
+ *                                               //   Boyer-Moore-Horspool without SIMD
+ *
+ * Every 32-byte block yields a bit mask of delimiter positions at once, so short fields don't pay
+ * a find() call each.
+ *
+ * Results are the same as the classic find() loop: n delimiters always give n + 1 fields, empty ones included,
+ * and multi-byte matches don't overlap.
+ *
+ * A Splitter must outlive the views it creates.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simd.hpp"
+
+
+namespace split {
+
+    class Splitter {
+    public:
+        enum class Kind : std::uint8_t {
+            byte,     // single delimiter byte
+            anyOf,    // any byte from a set
+            sequence, // multi-byte delimiter
+        };
+
+        explicit Splitter(const char delimiter) : kind_(Kind::byte), needle_(1, delimiter) {
+            init();
+        }
+
+        /**
+         * @param delimiter one or more bytes, matched as a whole
+         * @throws std::invalid_argument on empty delimiter (see utf8::sequences() for code point splitting)
+         */
+        explicit Splitter(const std::string_view &delimiter) :
+            kind_(delimiter.size() == 1 ? Kind::byte : Kind::sequence), needle_(delimiter) {
+            if (delimiter.empty()) {
+                throw std::invalid_argument("empty delimiter");
+            }
+            init();
+        }
+
+        // Split on any of the given bytes, e.g. ",;\t"
+        [[nodiscard]] static auto anyOf(const std::string_view &bytes) -> Splitter {
+            if (bytes.empty()) {
+                throw std::invalid_argument("empty delimiter set");
+            }
+            return Splitter(Kind::anyOf, bytes);
+        }
+
+        [[nodiscard]] auto kind() const noexcept -> Kind { return kind_; }
+
+        // Bytes to skip over a match
+        [[nodiscard]] auto delimiterLength() const noexcept -> std::size_t {
+            return kind_ == Kind::sequence ? needle_.size() : 1;
+        }
+
+        /**
+         * Iterates delimiter positions of a string, one 32-byte mask at a time.
+         */
+        class Scanner {
+        public:
+            Scanner() = default;
+            Scanner(const Splitter *splitter, const std::string_view &str) :
+                splitter_(splitter), str_(str), block_(0), mask_(0), next_(0) {
+                const std::size_t length = splitter->delimiterLength();
+                // Delimiter can start at [0, size - length]
+                limit_ = str.size() >= length ? str.size() - length + 1 : 0;
+                if (splitter->maskFn_ && limit_ > 0) {
+                    mask_ = loadMask(0);
+                }
+            }
+
+            // Next delimiter position, or npos
+            auto next() -> std::size_t {
+                if (!splitter_->maskFn_) {
+                    // Scalar: memchr / bitmap / Horspool
+                    if (next_ >= limit_) return std::string_view::npos;
+                    const std::size_t pos = splitter_->findScalar(str_, next_);
+                    next_ = pos == std::string_view::npos ? limit_ : pos + splitter_->delimiterLength();
+                    return pos;
+                }
+                while (true) {
+                    while (mask_) {
+                        const std::size_t pos = block_ + static_cast<std::size_t>(__builtin_ctz(mask_));
+                        mask_ &= mask_ - 1;
+                        if (pos >= next_) {
+                            // Skip candidates inside this match (overlapping multi-byte delimiters)
+                            next_ = pos + splitter_->delimiterLength();
+                            return pos;
+                        }
+                    }
+                    block_ += 32;
+                    if (block_ >= limit_) return std::string_view::npos;
+                    mask_ = loadMask(block_);
+                }
+            }
+
+        private:
+            static constexpr std::size_t tailCapacity = 64;
+
+            auto loadMask(const std::size_t block) const -> std::uint32_t {
+                const auto *p = reinterpret_cast<const unsigned char *>(str_.data()) + block;
+                // Vector loads read 32 + length - 1 bytes
+                const std::size_t window = 32 + splitter_->delimiterLength() - 1;
+                if (block + window <= str_.size()) {
+                    return splitter_->maskFn_(*splitter_, p);
+                }
+                // Tail (and short strings): copy into a padded buffer, drop positions past the limit
+                const std::size_t valid = limit_ - block;
+                if (window <= tailCapacity) {
+                    unsigned char tail[tailCapacity];
+                    std::memcpy(tail, p, str_.size() - block);
+                    std::memset(tail + (str_.size() - block), 0, tailCapacity - (str_.size() - block));
+                    return splitter_->maskFn_(*splitter_, tail) & (valid >= 32 ? ~0u : (1u << valid) - 1);
+                }
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < valid && i < 32; ++i) {
+                    mask |= static_cast<std::uint32_t>(splitter_->matchesAt(p + i)) << i;
+                }
+                return mask;
+            }
+
+            const Splitter *splitter_ = nullptr;
+            std::string_view str_;
+            std::size_t limit_ = 0;
+            std::size_t block_ = 0;
+            std::uint32_t mask_ = 0;
+            std::size_t next_ = 0;
+        };
+
+        // Position of the first delimiter at or after `from`, or npos
+        [[nodiscard]] auto find(const std::string_view &str, const std::size_t from = 0) const -> std::size_t {
+            if (from > str.size()) return std::string_view::npos;
+            Scanner scanner(this, str.substr(from));
+            const std::size_t pos = scanner.next();
+            return pos == std::string_view::npos ? pos : pos + from;
+        }
+
+        /**
+         * Lazy forward range of fields.
+         */
+        class FieldView : public std::ranges::view_interface<FieldView> {
+        public:
+            class Iterator {
+            public:
+                using iterator_concept = std::forward_iterator_tag;
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::string_view;
+                using difference_type = std::ptrdiff_t;
+
+                Iterator() = default;
+                Iterator(const Splitter *splitter, const std::string_view &str) :
+                    scanner_(splitter, str), str_(str), length_(splitter->delimiterLength()) {
+                    delimiter_ = scanner_.next();
+                }
+
+                [[nodiscard]] auto operator*() const -> std::string_view {
+                    return str_.substr(start_, delimiter_ == std::string_view::npos ? delimiter_ : delimiter_ - start_);
+                }
+
+                auto operator++() -> Iterator & {
+                    if (delimiter_ == std::string_view::npos) {
+                        done_ = true;
+                    } else {
+                        start_ = delimiter_ + length_;
+                        delimiter_ = scanner_.next();
+                    }
+                    return *this;
+                }
+
+                auto operator++(int) -> Iterator {
+                    Iterator copy = *this;
+                    ++*this;
+                    return copy;
+                }
+
+                [[nodiscard]] friend auto operator==(const Iterator &a, const Iterator &b) noexcept -> bool {
+                    return a.done_ == b.done_ && (a.done_ || a.start_ == b.start_);
+                }
+                [[nodiscard]] friend auto operator==(const Iterator &it, std::default_sentinel_t) noexcept -> bool {
+                    return it.done_;
+                }
+
+            private:
+                Scanner scanner_;
+                std::string_view str_;
+                std::size_t length_ = 1;
+                std::size_t start_ = 0;
+                std::size_t delimiter_ = std::string_view::npos;
+                bool done_ = false;
+            };
+
+            FieldView() = default;
+            FieldView(const Splitter *splitter, const std::string_view &str) : splitter_(splitter), str_(str) {}
+
+            [[nodiscard]] auto begin() const -> Iterator { return {splitter_, str_}; }
+            [[nodiscard]] auto end() const noexcept -> std::default_sentinel_t { return std::default_sentinel; }
+
+        private:
+            const Splitter *splitter_ = nullptr;
+            std::string_view str_;
+        };
+
+        // for (std::string_view field : splitter.split(line)) ...
+        [[nodiscard]] auto split(const std::string_view &str) const -> FieldView {
+            return {this, str};
+        }
+
+        /**
+         * Split into an existing vector: cleared first, its capacity is reused across calls.
+         * Any allocator, e.g. a std::pmr::vector.
+         *
+         * @return number of fields
+         */
+        template<typename Allocator>
+        auto splitInto(const std::string_view &str, std::vector<std::string_view, Allocator> &out) const -> std::size_t {
+            out.clear();
+            Scanner scanner(this, str);
+            const std::size_t length = delimiterLength();
+            std::size_t start = 0;
+            for (std::size_t pos = scanner.next(); pos != std::string_view::npos; pos = scanner.next()) {
+                out.emplace_back(str.data() + start, pos - start);
+                start = pos + length;
+            }
+            out.emplace_back(str.data() + start, str.size() - start);
+            return out.size();
+        }
+
+        /**
+         * Split into a fixed buffer, no allocation at all.
+         *
+         * @return number of fields written; when `out` is full, the last field holds the unsplit rest
+         */
+        auto splitInto(const std::string_view &str, const std::span<std::string_view> out) const -> std::size_t {
+            if (out.empty()) return 0;
+            Scanner scanner(this, str);
+            const std::size_t length = delimiterLength();
+            std::size_t start = 0;
+            std::size_t count = 0;
+            for (std::size_t pos = scanner.next(); pos != std::string_view::npos && count + 1 < out.size();
+                 pos = scanner.next()) {
+                out[count++] = str.substr(start, pos - start);
+                start = pos + length;
+            }
+            out[count++] = str.substr(start);
+            return count;
+        }
+
+    private:
+        Splitter(const Kind kind, const std::string_view &bytes) : kind_(kind), needle_(bytes) {
+            init();
+        }
+
+        using MaskFn = std::uint32_t (*)(const Splitter &, const unsigned char *);
+
+        void init() {
+            for (const char c : needle_) {
+                const auto byte = static_cast<unsigned char>(c);
+                bitmap_[byte >> 6] |= std::uint64_t{1} << (byte & 63);
+            }
+
+
+            if (kind_ == Kind::anyOf) {
+                // Shufti: one bucket bit per distinct high nibble, exact while there are at most 8 of them
+                std::array<int, 16> bucket{};
+                bucket.fill(-1);
+                int buckets = 0;
+                for (std::size_t byte = 0; byte < 256; ++byte) {
+                    if (!(bitmap_[byte >> 6] >> (byte & 63) & 1)) continue;
+                    const std::size_t hi = byte >> 4;
+                    if (bucket[hi] < 0) bucket[hi] = buckets++;
+                    if (bucket[hi] < 8) {
+                        lowNibble_[byte & 15] |= static_cast<std::uint8_t>(1u << bucket[hi]);
+                        highNibble_[hi] = static_cast<std::uint8_t>(1u << bucket[hi]);
+                    }
+                }
+                shuftiExact_ = buckets <= 8;
+            }
+
+            maskFn_ = selectMaskFn();
+
+            if (kind_ == Kind::sequence && !maskFn_) {
+                // Horspool bad-character shifts, based on the last byte of the window.
+                // Capped at 255: a shorter shift is still safe
+                const std::size_t length = needle_.size();
+                skip_.fill(static_cast<std::uint8_t>(std::min<std::size_t>(length, 255)));
+                for (std::size_t i = 0; i + 1 < length; ++i) {
+                    skip_[static_cast<unsigned char>(needle_[i])] =
+                        static_cast<std::uint8_t>(std::min<std::size_t>(length - 1 - i, 255));
+                }
+            }
+        }
+
+        [[nodiscard]] auto matchesAt(const unsigned char *p) const -> bool {
+            switch (kind_) {
+                case Kind::byte: return *p == static_cast<unsigned char>(needle_[0]);
+                case Kind::anyOf: return bitmap_[*p >> 6] >> (*p & 63) & 1;
+                case Kind::sequence: return std::memcmp(p, needle_.data(), needle_.size()) == 0;
+            }
+            return false;
+        }
+
+        [[nodiscard]] auto findScalar(const std::string_view &str, const std::size_t from) const -> std::size_t {
+            const auto *begin = reinterpret_cast<const unsigned char *>(str.data());
+            const std::size_t size = str.size();
+            switch (kind_) {
+                case Kind::byte: {
+                    const void *hit = std::memchr(begin + from, needle_[0], size - from);
+                    return hit ? static_cast<std::size_t>(static_cast<const unsigned char *>(hit) - begin)
+                               : std::string_view::npos;
+                }
+                case Kind::anyOf:
+                    for (std::size_t i = from; i < size; ++i) {
+                        if (matchesAt(begin + i)) return i;
+                    }
+                    return std::string_view::npos;
+                case Kind::sequence: {
+                    const std::size_t length = needle_.size();
+                    const auto last = static_cast<unsigned char>(needle_.back());
+                    for (std::size_t i = from; i + length <= size; i += skip_[begin[i + length - 1]]) {
+                        if (begin[i + length - 1] == last && std::memcmp(begin + i, needle_.data(), length - 1) == 0) {
+                            return i;
+                        }
+                    }
+                    return std::string_view::npos;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+#if defined(GOTCHAS_HAS_SIMD)
+
+        GOTCHAS_TARGET("avx2")
+        static auto maskByteAVX2(const Splitter &self, const unsigned char *p) -> std::uint32_t {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i hit = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(self.needle_[0]));
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(hit));
+        }
+
+        GOTCHAS_TARGET("sse2")
+        static auto maskByteSSE2(const Splitter &self, const unsigned char *p) -> std::uint32_t {
+            const __m128i needle = _mm_set1_epi8(self.needle_[0]);
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, needle))) |
+                   static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, needle))) << 16;
+        }
+
+        // Byte is in the set when lowNibble[byte & 15] & highNibble[byte >> 4] != 0
+        GOTCHAS_TARGET("avx2")
+        static auto maskAnyOfAVX2(const Splitter &self, const unsigned char *p) -> std::uint32_t {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(self.lowNibble_.data()));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(self.highNibble_.data()));
+            const __m256i lowTable = _mm256_broadcastsi128_si256(low);
+            const __m256i highTable = _mm256_broadcastsi128_si256(high);
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i lo = _mm256_shuffle_epi8(lowTable, _mm256_and_si256(block, nibble));
+            const __m256i hi = _mm256_shuffle_epi8(highTable, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+            const __m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+            return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(miss));
+        }
+
+        // Compare the first and the last needle byte at 32 positions, verify candidates with memcmp
+        GOTCHAS_TARGET("avx2")
+        static auto maskSequenceAVX2(const Splitter &self, const unsigned char *p) -> std::uint32_t {
+            const std::size_t length = self.needle_.size();
+            const __m256i first = _mm256_set1_epi8(self.needle_.front());
+            const __m256i last = _mm256_set1_epi8(self.needle_.back());
+            const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + length - 1));
+            const __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last));
+            auto candidates = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit));
+            if (length <= 2) return candidates;
+
+            std::uint32_t mask = 0;
+            while (candidates) {
+                const int i = __builtin_ctz(candidates);
+                if (std::memcmp(p + i + 1, self.needle_.data() + 1, length - 2) == 0) mask |= 1u << i;
+                candidates &= candidates - 1;
+            }
+            return mask;
+        }
+
+        GOTCHAS_TARGET("sse2")
+        static auto maskSequenceSSE2(const Splitter &self, const unsigned char *p) -> std::uint32_t {
+            const std::size_t length = self.needle_.size();
+            const __m128i first = _mm_set1_epi8(self.needle_.front());
+            const __m128i last = _mm_set1_epi8(self.needle_.back());
+            std::uint32_t candidates = 0;
+            for (int half = 0; half < 2; ++half) {
+                const unsigned char *q = p + half * 16;
+                const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q));
+                const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + length - 1));
+                const __m128i hit = _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last));
+                candidates |= static_cast<std::uint32_t>(_mm_movemask_epi8(hit)) << (half * 16);
+            }
+            if (length <= 2) return candidates;
+
+            std::uint32_t mask = 0;
+            while (candidates) {
+                const int i = __builtin_ctz(candidates);
+                if (std::memcmp(p + i + 1, self.needle_.data() + 1, length - 2) == 0) mask |= 1u << i;
+                candidates &= candidates - 1;
+            }
+            return mask;
+        }
+
+#endif
+
+        [[nodiscard]] auto selectMaskFn() const -> MaskFn {
+#if defined(GOTCHAS_HAS_SIMD)
+            const simd::Level level = simd::level();
+            switch (kind_) {
+                case Kind::byte:
+                    if (level == simd::Level::avx2) return &maskByteAVX2;
+                    if (level == simd::Level::sse2) return &maskByteSSE2;
+                    break;
+                case Kind::anyOf:
+                    if (level == simd::Level::avx2 && shuftiExact_) return &maskAnyOfAVX2;
+                    break;
+                case Kind::sequence:
+                    if (level == simd::Level::avx2) return &maskSequenceAVX2;
+                    if (level == simd::Level::sse2) return &maskSequenceSSE2;
+                    break;
+            }
+#endif
+            return nullptr;
+        }
+
+        Kind kind_;
+        std::string needle_;
+        std::array<std::uint64_t, 4> bitmap_{};
+        std::array<std::uint8_t, 256> skip_{};
+        std::array<std::uint8_t, 16> lowNibble_{};
+        std::array<std::uint8_t, 16> highNibble_{};
+        bool shuftiExact_ = false;
+        MaskFn maskFn_ = nullptr;
+    };
+
+}
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<split::Splitter::FieldView> = true;
@@ -6,17 +6,18 @@
  */
 
 
-#include <algorithm>
-#include <cctype>
-#include <cwctype>
+#include <cstdint>
 #include <format>
 #include <iostream>
 #include <locale>
 #include <ranges>
-#include <sstream>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "arena.hpp"
+#include "strings.hpp"
+
 
 /**
  * UTF-8 string example:
@@ -30,219 +31,6 @@
 const std::string hello = "¶ Hi 早安 🐳";
 
 
-[[nodiscard]] auto toLower(const std::string &str) -> std::string {
-    std::string result = str; // explicit copy ref
-    std::ranges::transform(
-        result,
-        result.begin(),
-        [](const unsigned char c) { return std::tolower(c); }
-    );
-    return result;
-}
-
-/**
- * ASCII-only version.
- *
- * @param str input
- * @return string
- */
-[[nodiscard]] auto toUpper(const std::string &str) -> std::string {
-    std::string result = str; // explicit copy ref
-    std::ranges::transform(
-        result,
-        result.begin(),
-        [](const unsigned char c) { return std::toupper(c); }
-    );
-    return result;
-}
-
-/**
- * Wide strings version.
- *
- * Usage:
- *  std::locale::global( std::locale("en_US.UTF-8") );
- *  std::wstring str1 = L"naïve 😀";
- *  std::wcout << toUpper(str1) << L'\n';
- *
- * @param str mixed-case wide string input
- * @param loc locale (optional)
- * @return upper-case wide string
- */
-[[nodiscard]] auto toUpper(const std::wstring &str, const std::locale &loc = std::locale()) -> std::wstring {
-    std::wstring result = str; // explicit copy ref
-    std::ranges::transform(
-        result,
-        result.begin(),
-        [&loc](const wchar_t c) { return std::toupper(c, loc); }
-    );
-    return result;
-}
-
-
-/**
- * Split UTF-8 string into individual code points (each represented as a string, not char)
- * See also: https://en.wikipedia.org/wiki/UTF-8#Description
- *
- * @param str UTF-8 string / string_view
- * @return vector of string_views referencing each code point
- */
-[[nodiscard]] auto splitIntoCodePoints(const std::string_view &str) -> std::vector<std::string_view> {
-    std::vector<std::string_view> codePoints;
-
-    size_t i = 0;
-    while (i < str.size()) {
-        // Cast the leading byte as char8_t (unsigned) to avoid sign issues
-        const char8_t leadByte = static_cast<char8_t>(str[i]);
-
-        // Determine sequence length from the leading byte
-        // Default is plain ASCII, U+0000 to U+007F, 1-byte length
-        size_t charLen = 1;
-
-        if (leadByte >= 0xF0) { // 4-byte sequence (U+10000 to U+10FFFF), 11110*** = 0xF0
-            charLen = 4;
-        } else if (leadByte >= 0xE0) { // 3-byte sequence (U+0800 to U+FFFF), 1110**** = 0xE0
-            charLen = 3;
-        } else if (leadByte >= 0xC0) { // 2-byte sequence (U+0080 to U+07FF), 110***** = 0xC0
-            charLen = 2;
-        }
-
-        // Ensure we don't exceed the string bounds
-        if (i + charLen > str.size()) {
-            // Probably string is malformed. Will use remaining bytes as a single codepoint
-            charLen = str.size() - i;
-        }
-
-        // Add the substring view and advance the index
-        codePoints.push_back(str.substr(i, charLen));
-        i += charLen;
-    }
-
-    return codePoints;
-}
-
-
-[[nodiscard]] auto splitString(const std::string_view &str, const char delimiter) -> std::vector<std::string_view> {
-    std::vector<std::string_view> result;
-    size_t start = 0;
-    size_t end = str.find(delimiter);
-
-    while (end != std::string_view::npos) {
-        result.push_back(str.substr(start, end - start));
-        start = end + 1;
-        end = str.find(delimiter, start);
-    }
-
-    result.push_back(str.substr(start));
-    return result;
-}
-
-[[nodiscard]] auto splitString(const std::string_view &str, const std::string &delimiter = "") -> std::vector<std::string_view> {
-    std::vector<std::string_view> result;
-
-    if (delimiter.empty()) {
-        return splitIntoCodePoints(str);
-    }
-
-    size_t start = 0;
-    size_t end = str.find(delimiter);
-
-    while (end != std::string::npos) {
-        result.push_back(str.substr(start, end - start));
-        start = end + delimiter.length();
-        end = str.find(delimiter, start);
-    }
-
-    result.push_back(str.substr(start));
-    return result;
-}
-
-
-// Decode a string-represented UTF-8 code point from string into a UTF-32 character (4-byte fixed width)
-[[nodiscard]] auto decodeCodePoint(const std::string_view &codePoint) -> char32_t {
-    char32_t wChr = 0;
-
-    switch (codePoint.length()) {
-        case 1:
-            wChr = codePoint.at(0);
-            break;
-        case 2:
-            // Implicit cast from binary-manipulated chars to char32_t should be fine here
-            wChr = ((codePoint.at(0) & 0x1F) << 6)
-                 | (codePoint.at(1) & 0x3F);
-            break;
-        case 3:
-            wChr = ((codePoint.at(0) & 0x0F) << 12)
-                 | ((codePoint.at(1) & 0x3F) << 6)
-                 | (codePoint.at(2) & 0x3F);
-            break;
-        case 4:
-            wChr = ((codePoint.at(0) & 0x07) << 18)
-                 | ((codePoint.at(1) & 0x3F) << 12)
-                 | ((codePoint.at(2) & 0x3F) << 6)
-                 | (codePoint.at(3) & 0x3F);
-            break;
-        default:
-            wChr = 0xFFFD; // >4 bytes, invalid code point: �
-    }
-
-    return wChr;
-}
-
-// Encode a UTF-32 character into a string-represented UTF-8 code point
-// See also: https://en.wikipedia.org/wiki/UTF-8#Description
-[[nodiscard]] auto encodeUTF8(const char32_t wChr) -> std::string {
-    std::string result;
-
-    if (wChr <= 0x7F) {
-        // U+0000 to U+007F, 1-byte
-        result = static_cast<char8_t>(wChr);
-    } else if (wChr <= 0x7FF) {
-        // U+0080 to U+07FF, 2-byte
-        result = static_cast<char8_t>(0xC0 | ((wChr >> 6) & 0x1F));
-        result += static_cast<char8_t>(0x80 | (wChr & 0x3F));
-    } else if (wChr <= 0xFFFF) {
-        // U+0800 to U+FFFF, 3-byte
-        result = static_cast<char8_t>(0xE0 | ((wChr >> 12) & 0x0F));
-        result += static_cast<char8_t>(0x80 | ((wChr >> 6) & 0x3F));
-        result += static_cast<char8_t>(0x80 | (wChr & 0x3F));
-    } else if (wChr <= 0x10FFFF) {
-        // U+10000 to U+10FFFF, 4-byte
-        result = static_cast<char8_t>(0xF0 | ((wChr >> 18) & 0x07));
-        result += static_cast<char8_t>(0x80 | ((wChr >> 12) & 0x3F));
-        result += static_cast<char8_t>(0x80 | ((wChr >> 6) & 0x3F));
-        result += static_cast<char8_t>(0x80 | (wChr & 0x3F));
-    } else {
-        // Invalid code point (out of U+10FFFF range)
-        // Append replacement character U+FFFD
-        result = "�";
-    }
-
-    return result;
-}
-
-// Function to convert UTF-8 encoded string to uppercase
-// UTF-8 sequence → code points[] → wchar_t[] → toupper → join
-std::string toUpperCase(const std::string_view &str, const std::locale &loc = std::locale()) {
-    std::string result;
-    const auto codePoints = splitIntoCodePoints(str);
-
-    for (const std::string_view &codePoint : codePoints) {
-        // Decode to 4-byte char
-        const char32_t cp = decodeCodePoint(codePoint);
-        // Cast to wide char
-        const wchar_t chr = static_cast<wchar_t>(cp);
-        // Convert to uppercase using std::locale::toupper
-        const wchar_t upperChr = std::toupper<wchar_t>(chr, loc);
-        // Cast back to UTF-32 char
-        const char32_t upperCp = static_cast<char32_t>(upperChr);
-        // Encode to UTF-8 code point
-        result += encodeUTF8(upperCp);
-    }
-
-    return result;
-}
-
-
 // GCC:
 // g++ -std=c++23 strings.cpp -o /tmp/strings && /tmp/strings
 // Clang:
@@ -276,19 +64,91 @@ int main() {
         splitString(hello, "早安")
     );
 
+    // Reusable splitter and output vector: the delimiter is preprocessed once, no allocation per line
+    const auto fieldSeparators = split::Splitter::anyOf(",;\t");
+    std::vector<std::string_view> fields;
+    for (const std::string_view line : {"a,b;c\td", ";;x,"}) {
+        fieldSeparators.splitInto(line, fields);
+        std::cout << std::format("Split by any of \",;\\t\": \"{0}\" → {1}\n", line, fields);
+    }
+
     std::cout << std::format(
         "Code points: \"{0}\" → {1}\n",
         hello,
         splitString(hello)
     );
 
+    // Malformed input: overlong encoding of '/' (C0 AF)
+    const std::string strMalformed = "ok\xC0\xAF tail";
+    utf8::Error error;
+    const auto validPrefix = splitIntoCodePoints(strMalformed, error);
+    std::cout << std::format(
+        "Malformed: valid prefix → {0}, error at byte {1}: {2}\n",
+        validPrefix,
+        error.offset,
+        utf8::describe(error.status)
+    );
+
+    // Lazy code point view, composes with other views and allocates nothing by itself
+    auto firstThree = hello
+        | utf8::views::codePoints
+        | std::views::take(3)
+        | std::views::transform([](const char32_t cp) { return static_cast<std::uint32_t>(cp); });
+    std::cout << std::format("First 3 code points: \"{0}\" → {1::04X}\n", hello, firstThree);
+
+    // Encoding without temporary strings: into a caller buffer, or the whole UTF-32 string at once
+    char8_t buffer[4];
+    const std::size_t length = encodeUTF8(U'🐳', buffer);
+    std::cout << std::format(
+        "Encoded U+1F433 into {0} bytes: \"{1}\"\n",
+        length,
+        std::string_view(reinterpret_cast<const char *>(buffer), length)
+    );
+
+    const std::u32string strTestEncode = U"¶ Hi 早安 🐳";
+    std::cout << std::format("Bulk encode: {0} code points → \"{1}\"\n", strTestEncode.size(), encodeUTF8(strTestEncode));
+
+    // Bulk decode, ill-formed bytes become U+FFFD
+    const std::u32string decoded = decodeUTF8(hello + "\xE6\x97");
+    std::cout << std::format(
+        "Bulk decode: \"{0}\" + E6 97 → {1::04X}\n",
+        hello,
+        decoded | std::views::transform([](const char32_t cp) { return static_cast<std::uint32_t>(cp); })
+    );
+
+    // Streaming decode: 🐳 is cut in half between two chunks, the unfinished bytes are carried over
+    const std::string_view chunk1 = std::string_view(hello).substr(0, hello.size() - 2);
+    const std::string_view chunk2 = std::string_view(hello).substr(hello.size() - 2);
+    std::u32string streamed(hello.size(), U'\0');
+    const utf8::DecodeResult first = decodeUTF8(chunk1, streamed, false);
+    const std::string carry = std::string(chunk1.substr(first.consumed)) + std::string(chunk2);
+    const utf8::DecodeResult second = decodeUTF8(carry, std::span(streamed).subspan(first.written));
+    std::cout << std::format(
+        "Streaming decode: chunk 1 consumed {0} of {1} bytes, total {2} code points, {3} replaced\n",
+        first.consumed,
+        chunk1.size(),
+        first.written + second.written,
+        first.replaced + second.replaced
+    );
+
+    // ASCII-only case conversion without allocation: in place, or into a stack buffer
+    std::string strTestAscii = "X-Forwarded-For";
+    toUpper(std::span<char>(strTestAscii));
+    char headerKey[32];
+    const std::size_t headerKeyLength = toLower(strTestAscii, headerKey);
+    std::cout << std::format(
+        "ASCII in place: \"{0}\", into buffer: \"{1}\"\n",
+        strTestAscii,
+        std::string_view(headerKey, headerKeyLength)
+    );
+
     // Test cases including multi-codepoint mappings
     std::string strTestUpper1 = "hello🌍world";
     std::string strTestUpper2 = "naïve café";
     std::string strTestUpper3 = "αβγδε"; // Greek
     std::string strTestUpper4 = "привет мир"; // Cyrillic
     std::string strTestUpper5 = "MixeD_CaSe1_ÄÖÜ #üñö!"; // Mixed latin
-    std::string strTestUpper6 = "Straße"; // German with ß, should be capitalized as ẞ
+    std::string strTestUpper6 = "Straße"; // German with ß, full mapping (SpecialCasing.txt) is SS, not ẞ
     std::string strTestUpper7 = "æon+早安øӕ"; // Mixed with ligatures U+00E6, U+04D5
 
 
@@ -316,6 +176,34 @@ int main() {
     std::cout << std::format("German: \"{0}\" → \"{1}\"\n", strTestUpper6, toUpperCase(strTestUpper6));
     std::cout << std::format("Ligatures mixed: \"{0}\" → \"{1}\"\n", strTestUpper7, toUpperCase(strTestUpper7));
 
+    // std::locale can only do 1:1 mappings
+    std::cout << std::format(
+        "German with std::locale: \"{0}\" → \"{1}\"\n",
+        strTestUpper6,
+        toUpperCase(strTestUpper6, std::locale())
+    );
+
+    const std::string strTestTitle = "ǆemal o'neil ΣΊΣΥΦΟΣ";
+    std::cout << std::format("Lowercase: \"{0}\" → \"{1}\"\n", strTestTitle, toLowerCase(strTestTitle));
+    std::cout << std::format("Titlecase: \"{0}\" → \"{1}\"\n", strTestTitle, toTitleCase(strTestTitle));
+    std::cout << std::format("Case folding: \"{0}\" → \"{1}\"\n", strTestUpper6, foldCase(strTestUpper6));
+
+    // Per-request string work on an arena: the std::pmr overloads bump-allocate, reset() frees it all at once
+    arena::Arena arena;
+    for (const std::string_view request : {"get,/index.html,straße", "put,/早安,🐳"}) {
+        {
+            const auto fields = splitString(request, ',', arena.resource());
+            std::cout << std::format(
+                "Arena: \"{0}\" → {1}, {2}\n",
+                request,
+                fields,
+                toUpperCase(fields.back(), arena.resource())
+            );
+        }
+        // After the containers on the arena are gone
+        arena.reset();
+    }
+
 
     std::cout.flush();
     return 0;
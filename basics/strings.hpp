@@ -0,0 +1,361 @@
+/**
+ * strings
+ *
+ * String helpers: ASCII and locale case conversion, splitting, UTF-8 encode/decode.
+ * Usage example: strings.cpp
+ * Functions that allocate have an overload taking a std::pmr::memory_resource*, returning std::pmr containers:
+ * with an arena::Arena (arena.hpp) the string work of a whole request is released in one reset()
+ * Multithreaded versions for very large inputs: parallel.hpp
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cwctype>
+#include <locale>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ascii.hpp"
+#include "casemap.hpp"
+#include "split.hpp"
+#include "utf8.hpp"
+
+
+/**
+ * ASCII-only version, bytes >= 0x80 are kept as is. See ascii.hpp for the SIMD kernel.
+ *
+ * Overloads:
+ *  toLower(str)             copy
+ *  toLower(std::move(str))  in place, the buffer is reused
+ *  toLower(span)            in place, e.g. a char array or a slice of a bigger buffer
+ *  toLower(view, buffer)    into a caller buffer, returns bytes written (0 if too small)
+ *
+ * @param str input
+ * @return string
+ */
+[[nodiscard]] inline auto toLower(const std::string &str) -> std::string {
+    std::string result = str; // explicit copy ref
+    ascii::toLower(result);
+    return result;
+}
+
+[[nodiscard]] inline auto toLower(std::string &&str) -> std::string {
+    ascii::toLower(str);
+    return std::move(str);
+}
+
+inline void toLower(const std::span<char> str) noexcept {
+    ascii::toLower(str);
+}
+
+inline auto toLower(const std::string_view &str, const std::span<char> out) noexcept -> std::size_t {
+    return ascii::toLower(str, out);
+}
+
+// Copy allocated from `resource`, e.g. an arena
+[[nodiscard]] inline auto toLower(const std::string_view &str, std::pmr::memory_resource *resource) -> std::pmr::string {
+    std::pmr::string result(resource);
+    result.resize_and_overwrite(str.size(), [&str](char *data, const std::size_t size) {
+        return ascii::toLower(str, {data, size});
+    });
+    return result;
+}
+
+/**
+ * ASCII-only version, same overloads as toLower().
+ *
+ * @param str input
+ * @return string
+ */
+[[nodiscard]] inline auto toUpper(const std::string &str) -> std::string {
+    std::string result = str; // explicit copy ref
+    ascii::toUpper(result);
+    return result;
+}
+
+[[nodiscard]] inline auto toUpper(std::string &&str) -> std::string {
+    ascii::toUpper(str);
+    return std::move(str);
+}
+
+inline void toUpper(const std::span<char> str) noexcept {
+    ascii::toUpper(str);
+}
+
+inline auto toUpper(const std::string_view &str, const std::span<char> out) noexcept -> std::size_t {
+    return ascii::toUpper(str, out);
+}
+
+[[nodiscard]] inline auto toUpper(const std::string_view &str, std::pmr::memory_resource *resource) -> std::pmr::string {
+    std::pmr::string result(resource);
+    result.resize_and_overwrite(str.size(), [&str](char *data, const std::size_t size) {
+        return ascii::toUpper(str, {data, size});
+    });
+    return result;
+}
+
+/**
+ * Wide strings version.
+ *
+ * Usage:
+ *  std::locale::global( std::locale("en_US.UTF-8") );
+ *  std::wstring str1 = L"naïve 😀";
+ *  std::wcout << toUpper(str1) << L'\n';
+ *
+ * @param str mixed-case wide string input
+ * @param loc locale (optional)
+ * @return upper-case wide string
+ */
+[[nodiscard]] inline auto toUpper(const std::wstring &str, const std::locale &loc = std::locale()) -> std::wstring {
+    std::wstring result = str; // explicit copy ref
+    std::ranges::transform(
+        result,
+        result.begin(),
+        [&loc](const wchar_t c) { return std::toupper(c, loc); }
+    );
+    return result;
+}
+
+
+/**
+ * Split UTF-8 string into individual code points (each represented as a string, not char)
+ * See also: https://en.wikipedia.org/wiki/UTF-8#Description
+ *
+ * Input is fully validated first (overlong forms, surrogates, > U+10FFFF, stray or missing continuation bytes),
+ * then sequence boundaries are found with SIMD, see utf8.hpp.
+ *
+ * @param str UTF-8 string / string_view
+ * @param error set to the first ill-formed sequence, or to ok
+ * @return vector of string_views referencing each code point of the valid prefix
+ */
+[[nodiscard]] inline auto splitIntoCodePoints(const std::string_view &str, utf8::Error &error)
+        -> std::vector<std::string_view> {
+    error = utf8::validate(str);
+    const std::string_view valid = error.ok() ? str : str.substr(0, error.offset);
+
+    std::vector<std::string_view> codePoints;
+    codePoints.reserve(utf8::countCodePoints(valid));
+    utf8::appendSequences(valid, codePoints);
+    return codePoints;
+}
+
+/**
+ * Throwing version.
+ *
+ * @param str UTF-8 string / string_view
+ * @return vector of string_views referencing each code point
+ * @throws utf8::DecodeError on malformed input
+ */
+[[nodiscard]] inline auto splitIntoCodePoints(const std::string_view &str) -> std::vector<std::string_view> {
+    utf8::Error error;
+    auto codePoints = splitIntoCodePoints(str, error);
+    if (!error.ok()) {
+        throw utf8::DecodeError(error);
+    }
+    return codePoints;
+}
+
+// The vector is allocated from `resource`, e.g. an arena
+[[nodiscard]] inline auto splitIntoCodePoints(const std::string_view &str, utf8::Error &error,
+                                              std::pmr::memory_resource *resource) -> std::pmr::vector<std::string_view> {
+    error = utf8::validate(str);
+    const std::string_view valid = error.ok() ? str : str.substr(0, error.offset);
+
+    std::pmr::vector<std::string_view> codePoints(resource);
+    codePoints.reserve(utf8::countCodePoints(valid));
+    utf8::appendSequences(valid, codePoints);
+    return codePoints;
+}
+
+[[nodiscard]] inline auto splitIntoCodePoints(const std::string_view &str, std::pmr::memory_resource *resource)
+        -> std::pmr::vector<std::string_view> {
+    utf8::Error error;
+    auto codePoints = splitIntoCodePoints(str, error, resource);
+    if (!error.ok()) {
+        throw utf8::DecodeError(error);
+    }
+    return codePoints;
+}
+
+
+// For repeated splitting on the same delimiter, keep a split::Splitter and reuse an output vector (split.hpp)
+[[nodiscard]] inline auto splitString(const std::string_view &str, const char delimiter) -> std::vector<std::string_view> {
+    std::vector<std::string_view> result;
+    split::Splitter(delimiter).splitInto(str, result);
+    return result;
+}
+
+[[nodiscard]] inline auto splitString(const std::string_view &str, const std::string &delimiter = "") -> std::vector<std::string_view> {
+    if (delimiter.empty()) {
+        // Lenient: unlike splitIntoCodePoints(), ill-formed bytes become their own elements instead of throwing
+        return utf8::sequences(str) | std::ranges::to<std::vector<std::string_view>>();
+    }
+
+    std::vector<std::string_view> result;
+    split::Splitter(delimiter).splitInto(str, result);
+    return result;
+}
+
+// The vector is allocated from `resource`, e.g. an arena
+[[nodiscard]] inline auto splitString(const std::string_view &str, const char delimiter,
+                                      std::pmr::memory_resource *resource) -> std::pmr::vector<std::string_view> {
+    std::pmr::vector<std::string_view> result(resource);
+    split::Splitter(delimiter).splitInto(str, result);
+    return result;
+}
+
+[[nodiscard]] inline auto splitString(const std::string_view &str, const std::string_view &delimiter,
+                                      std::pmr::memory_resource *resource) -> std::pmr::vector<std::string_view> {
+    std::pmr::vector<std::string_view> result(resource);
+    if (delimiter.empty()) {
+        for (const std::string_view sequence : utf8::sequences(str)) result.push_back(sequence);
+        return result;
+    }
+    split::Splitter(delimiter).splitInto(str, result);
+    return result;
+}
+
+
+// Decode a string-represented UTF-8 code point from string into a UTF-32 character (4-byte fixed width)
+// Anything but exactly one well-formed sequence gives U+FFFD: �
+[[nodiscard]] inline auto decodeCodePoint(const std::string_view &codePoint) -> char32_t {
+    if (codePoint.empty() || codePoint.size() > 4) {
+        return utf8::replacementCharacter;
+    }
+    const unsigned char *bytes = utf8::bytes(codePoint);
+    const utf8::Sequence seq = utf8::decodeNext(bytes, bytes + codePoint.size());
+    return seq.length == codePoint.size() ? seq.codePoint : utf8::replacementCharacter;
+}
+
+// Decode a whole UTF-8 string at once, ill-formed sequences become U+FFFD
+[[nodiscard]] inline auto decodeUTF8(const std::string_view &str) -> std::u32string {
+    return utf8::decode(str);
+}
+
+/**
+ * Decode into a caller buffer, for streaming chunk by chunk.
+ *
+ * @param str UTF-8 chunk
+ * @param out destination, str.size() code points are always enough
+ * @param final false if more chunks follow: an incomplete trailing sequence is then left unconsumed
+ * @return bytes consumed, code points written, number of U+FFFD replacements
+ */
+inline auto decodeUTF8(const std::string_view &str, const std::span<char32_t> out, const bool final = true)
+        -> utf8::DecodeResult {
+    return utf8::decode(str, out, final);
+}
+
+// Encode a UTF-32 character into a string-represented UTF-8 code point
+// See also: https://en.wikipedia.org/wiki/UTF-8#Description
+// Surrogates and code points out of U+10FFFF range are encoded as replacement character U+FFFD: �
+[[nodiscard]] inline auto encodeUTF8(const char32_t wChr) -> std::string {
+    char buffer[4];
+    return {buffer, utf8::encodeUnchecked(wChr, buffer)};
+}
+
+[[nodiscard]] inline auto encodeUTF8(const char32_t wChr, std::pmr::memory_resource *resource) -> std::pmr::string {
+    char buffer[4];
+    return {buffer, utf8::encodeUnchecked(wChr, buffer), resource};
+}
+
+/**
+ * Allocation-free version: encode into a caller buffer.
+ *
+ * @param wChr UTF-32 character
+ * @param out destination buffer, 4 bytes are always enough
+ * @return number of bytes written, 0 if `out` is too small
+ */
+inline auto encodeUTF8(const char32_t wChr, const std::span<char8_t> out) -> std::size_t {
+    return utf8::encode(wChr, out);
+}
+
+// Output iterator version, e.g. std::back_inserter(reservedString)
+template<std::output_iterator<char> OutputIt>
+requires (!std::same_as<OutputIt, char8_t *>) // char8_t arrays go to the bounds-checked span overload
+auto encodeUTF8(const char32_t wChr, OutputIt out) -> OutputIt {
+    return utf8::encode(wChr, out);
+}
+
+// Bulk version: UTF-32 → UTF-8 with exactly one allocation
+[[nodiscard]] inline auto encodeUTF8(const std::span<const char32_t> wStr) -> std::string {
+    return utf8::encode(wStr);
+}
+
+[[nodiscard]] inline auto encodeUTF8(const std::span<const char32_t> wStr, std::pmr::memory_resource *resource)
+        -> std::pmr::string {
+    std::pmr::string result(resource);
+    result.resize_and_overwrite(utf8::encodedLength(wStr), [&wStr](char *data, const std::size_t size) {
+        return utf8::encode(wStr, {reinterpret_cast<char8_t *>(data), size});
+    });
+    return result;
+}
+
+// Full Unicode case mapping, locale-independent, works on UTF-8 bytes directly (see casemap.hpp):
+// "Straße" → "STRASSE". Ill-formed sequences come out as U+FFFD.
+[[nodiscard]] inline auto toUpperCase(const std::string_view &str) -> std::string {
+    return casemap::toUpper(str);
+}
+
+[[nodiscard]] inline auto toLowerCase(const std::string_view &str) -> std::string {
+    return casemap::toLower(str);
+}
+
+[[nodiscard]] inline auto toTitleCase(const std::string_view &str) -> std::string {
+    return casemap::toTitle(str);
+}
+
+// Case folding, for caseless comparison
+[[nodiscard]] inline auto foldCase(const std::string_view &str) -> std::string {
+    return casemap::fold(str);
+}
+
+// Same, allocated from `resource`, e.g. an arena
+[[nodiscard]] inline auto toUpperCase(const std::string_view &str, std::pmr::memory_resource *resource) -> std::pmr::string {
+    std::pmr::string result(resource);
+    casemap::append(result, str, casemap::Mapping::upper);
+    return result;
+}
+
+[[nodiscard]] inline auto toLowerCase(const std::string_view &str, std::pmr::memory_resource *resource) -> std::pmr::string {
+    std::pmr::string result(resource);
+    casemap::append(result, str, casemap::Mapping::lower);
+    return result;
+}
+
+[[nodiscard]] inline auto toTitleCase(const std::string_view &str, std::pmr::memory_resource *resource) -> std::pmr::string {
+    std::pmr::string result(resource);
+    casemap::append(result, str, casemap::Mapping::title);
+    return result;
+}
+
+[[nodiscard]] inline auto foldCase(const std::string_view &str, std::pmr::memory_resource *resource) -> std::pmr::string {
+    std::pmr::string result(resource);
+    casemap::append(result, str, casemap::Mapping::fold);
+    return result;
+}
+
+// Function to convert UTF-8 encoded string to uppercase with std::locale (1:1 mappings only, ß stays ß)
+// UTF-8 sequence → code points (lazy, no intermediate vector) → wchar_t → toupper → join
+// Ill-formed sequences come out as U+FFFD.
+inline std::string toUpperCase(const std::string_view &str, const std::locale &loc) {
+    std::string result;
+    result.reserve(str.size());
+
+    for (const char32_t cp : utf8::codePoints(str)) {
+        // Cast to wide char
+        const wchar_t chr = static_cast<wchar_t>(cp);
+        // Convert to uppercase using std::locale::toupper
+        const wchar_t upperChr = std::toupper<wchar_t>(chr, loc);
+        // Cast back to UTF-32 char
+        const char32_t upperCp = static_cast<char32_t>(upperChr);
+        // Encode to UTF-8 code point, straight into the reserved result
+        utf8::append(result, upperCp);
+    }
+
+    return result;
+}
@@ -0,0 +1,1005 @@
+/**
+ * utf8
+ *
+ * Validating UTF-8 scanner used by basics/strings.hpp.
+ *
+ * Well-formed sequences (Unicode 15, Table 3-7):
+ *
+ *   U+0000..U+007F     00..7F
+ *   U+0080..U+07FF     C2..DF  80..BF
+ *   U+0800..U+0FFF     E0      A0..BF  80..BF
+ *   U+1000..U+CFFF     E1..EC  80..BF  80..BF
+ *   U+D000..U+D7FF     ED      80..9F  80..BF      (ED A0..BF would be a UTF-16 surrogate)
+ *   U+E000..U+FFFF     EE..EF  80..BF  80..BF
+ *   U+10000..U+3FFFF   F0      90..BF  80..BF  80..BF
+ *   U+40000..U+FFFFF   F1..F3  80..BF  80..BF  80..BF
+ *   U+100000..U+10FFFF F4      80..8F  80..BF  80..BF
+ *
+ * Everything else is either overlong (C0, C1, E0 80..9F, F0 80..8F), a surrogate, out of range (F4 90.., F5..FF)
+ * or structurally broken (stray continuation byte, missing continuation bytes, truncated input).
+ *
+ * utf8::encode() writes into caller-provided storage (span, output iterator, pre-reserved string) without
+ * temporary strings; the bulk overload sizes its output exactly in one (vectorized) counting pass.
+ *
+ * utf8::decode() transcodes whole buffers (or streaming chunks) to UTF-32, replacing ill-formed input with U+FFFD.
+ *
+ * utf8::sequences() / utf8::codePoints() are lazy, allocation-free views for when the whole vector is not needed.
+ *
+ * The AVX2 path implements the lookup algorithm from
+ * John Keiser, Daniel Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte" (2021):
+ * https://arxiv.org/abs/2010.03090
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simd.hpp"
+
+
+namespace utf8 {
+
+    enum class Status : std::uint8_t {
+        ok = 0,
+        unexpectedContinuation, // 80..BF where a lead byte is expected
+        invalidLeadByte,        // F8..FF can never appear in UTF-8
+        tooShort,               // lead byte not followed by enough continuation bytes
+        truncated,              // input ends in the middle of a sequence (may be completed by the next chunk)
+        overlong,               // C0, C1, E0 80..9F, F0 80..8F
+        surrogate,              // ED A0..BF: U+D800..U+DFFF
+        tooLarge,               // > U+10FFFF: F4 90..BF, F5..F7
+    };
+
+    [[nodiscard]] inline auto describe(const Status status) -> std::string_view {
+        switch (status) {
+            case Status::ok: return "ok";
+            case Status::unexpectedContinuation: return "unexpected continuation byte";
+            case Status::invalidLeadByte: return "invalid lead byte";
+            case Status::tooShort: return "missing continuation byte";
+            case Status::truncated: return "truncated sequence at end of input";
+            case Status::overlong: return "overlong encoding";
+            case Status::surrogate: return "UTF-16 surrogate code point";
+            case Status::tooLarge: return "code point above U+10FFFF";
+        }
+        return "unknown";
+    }
+
+    // Result of validation: status and byte offset of the first ill-formed sequence
+    struct Error {
+        Status status = Status::ok;
+        std::size_t offset = 0;
+
+        [[nodiscard]] constexpr auto ok() const noexcept -> bool { return status == Status::ok; }
+    };
+
+    // Thrown by the non-reporting overloads (same idea as std::filesystem: throw vs std::error_code&)
+    class DecodeError : public std::runtime_error {
+    public:
+        explicit DecodeError(const Error error) :
+            std::runtime_error("malformed UTF-8 at byte " + std::to_string(error.offset) + ": " +
+                               std::string(describe(error.status))),
+            error_(error) {}
+
+        [[nodiscard]] auto error() const noexcept -> Error { return error_; }
+
+    private:
+        Error error_;
+    };
+
+    // One decoded sequence.
+    // For ill-formed input, `length` is the maximal subpart (Unicode 15, §3.9 U+FFFD Substitution of Maximal Subparts)
+    // and `codePoint` is U+FFFD.
+    struct Sequence {
+        char32_t codePoint;
+        std::uint32_t length;
+        Status status;
+    };
+
+    inline constexpr char32_t replacementCharacter = 0xFFFD; // �
+
+    [[nodiscard]] constexpr auto isContinuation(const unsigned char byte) noexcept -> bool {
+        return (byte & 0xC0) == 0x80;
+    }
+
+    /**
+     * Decode a single sequence starting at `p` (scalar reference implementation).
+     *
+     * @param p first byte, must be < end
+     * @param end one past the last byte of input
+     * @return code point, consumed length and status
+     */
+    [[nodiscard]] constexpr auto decodeNext(const unsigned char *p, const unsigned char *end) noexcept -> Sequence {
+        const unsigned char lead = *p;
+        if (lead < 0x80) {
+            return {lead, 1, Status::ok};
+        }
+        if (lead < 0xC2) {
+            return {replacementCharacter, 1, lead < 0xC0 ? Status::unexpectedContinuation : Status::overlong};
+        }
+        if (lead > 0xF4) {
+            return {replacementCharacter, 1, lead < 0xF8 ? Status::tooLarge : Status::invalidLeadByte};
+        }
+
+        // Allowed range of the 2nd byte depends on the lead byte, the rest are always 80..BF
+        std::uint32_t need;
+        char32_t cp;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xBF;
+        Status rangeError = Status::tooShort;
+
+        if (lead < 0xE0) {
+            need = 1;
+            cp = lead & 0x1F;
+        } else if (lead < 0xF0) {
+            need = 2;
+            cp = lead & 0x0F;
+            if (lead == 0xE0) {
+                lo = 0xA0;
+                rangeError = Status::overlong;
+            } else if (lead == 0xED) {
+                hi = 0x9F;
+                rangeError = Status::surrogate;
+            }
+        } else {
+            need = 3;
+            cp = lead & 0x07;
+            if (lead == 0xF0) {
+                lo = 0x90;
+                rangeError = Status::overlong;
+            } else if (lead == 0xF4) {
+                hi = 0x8F;
+                rangeError = Status::tooLarge;
+            }
+        }
+
+        for (std::uint32_t k = 1; k <= need; ++k) {
+            if (p + k >= end) {
+                return {replacementCharacter, k, Status::truncated};
+            }
+            const unsigned char byte = p[k];
+            if (byte < lo || byte > hi) {
+                // A continuation byte outside of the narrowed 2nd-byte range is a specific error, anything else
+                // means the sequence is simply cut short
+                const Status status = (k == 1 && isContinuation(byte)) ? rangeError : Status::tooShort;
+                return {replacementCharacter, k, status};
+            }
+            cp = (cp << 6) | (byte & 0x3F);
+            lo = 0x80;
+            hi = 0xBF;
+        }
+
+        return {cp, need + 1, Status::ok};
+    }
+
+    [[nodiscard]] inline auto bytes(const std::string_view &str) noexcept -> const unsigned char * {
+        return reinterpret_cast<const unsigned char *>(str.data());
+    }
+
+
+    namespace detail {
+
+        inline auto validateScalar(const unsigned char *begin, const unsigned char *p, const unsigned char *end)
+                -> Error {
+            while (p < end) {
+                // Cheap ASCII skip, 8 bytes at a time
+                while (end - p >= 8) {
+                    std::uint64_t word;
+                    std::memcpy(&word, p, sizeof(word));
+                    if (word & 0x8080808080808080ULL) break;
+                    p += 8;
+                }
+                if (p == end) break;
+
+                const Sequence seq = decodeNext(p, end);
+                if (seq.status != Status::ok) {
+                    return {seq.status, static_cast<std::size_t>(p - begin)};
+                }
+                p += seq.length;
+            }
+            return {};
+        }
+
+        // Start of the sequence which may still be open at `p` (at most 3 bytes back)
+        inline auto rewindToLead(const unsigned char *begin, const unsigned char *p) -> const unsigned char * {
+            const unsigned char *start = (p - begin > 3) ? p - 3 : begin;
+            while (start < p && isContinuation(*start)) ++start;
+            return start;
+        }
+
+#if defined(GOTCHAS_HAS_SIMD)
+
+        // SSE2 can't do byte table lookups, so it is used to skip pure-ASCII 16-byte blocks only
+        GOTCHAS_TARGET("sse2")
+        inline auto validateSSE2(const unsigned char *begin, const unsigned char *end) -> Error {
+            const unsigned char *p = begin;
+            while (end - p >= 16) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                if (_mm_movemask_epi8(block) == 0) {
+                    p += 16;
+                    continue;
+                }
+                // Validate whole sequences until the block is consumed
+                const unsigned char *blockEnd = p + 16;
+                while (p < blockEnd) {
+                    const Sequence seq = decodeNext(p, end);
+                    if (seq.status != Status::ok) {
+                        return {seq.status, static_cast<std::size_t>(p - begin)};
+                    }
+                    p += seq.length;
+                }
+            }
+            return validateScalar(begin, p, end);
+        }
+
+
+        GOTCHAS_TARGET("avx2")
+        inline auto prevBytes1(const __m256i input, const __m256i prev) -> __m256i {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - 1);
+        }
+        GOTCHAS_TARGET("avx2")
+        inline auto prevBytes2(const __m256i input, const __m256i prev) -> __m256i {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - 2);
+        }
+        GOTCHAS_TARGET("avx2")
+        inline auto prevBytes3(const __m256i input, const __m256i prev) -> __m256i {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - 3);
+        }
+
+        // Classify every (previous byte, current byte) pair with three 16-entry nibble lookups.
+        // Each table entry is a bit set of error classes that the nibble is compatible with;
+        // a pair is valid only when the AND of the three lookups is zero.
+        GOTCHAS_TARGET("avx2")
+        inline auto checkBlockAVX2(const __m256i input, const __m256i prev) -> __m256i {
+            constexpr char TOO_SHORT = 1 << 0;  // 11______ 0_______  or  11______ 11______
+            constexpr char TOO_LONG = 1 << 1;   // 0_______ 10______
+            constexpr char OVERLONG_3 = 1 << 2; // 11100000 100_____
+            constexpr char SURROGATE = 1 << 4;  // 11101101 101_____
+            constexpr char OVERLONG_2 = 1 << 5; // 1100000_ 10______
+            constexpr char TWO_CONTS = static_cast<char>(1 << 7); // 10______ 10______
+            constexpr char TOO_LARGE = 1 << 3;  // 11110100 1001____ and above
+            constexpr char TOO_LARGE_1000 = 1 << 6; // 11110101+ 1000____
+            constexpr char OVERLONG_4 = 1 << 6; // 11110000 1000____
+            constexpr char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+            const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+            const __m256i prev1 = prevBytes1(input, prev);
+
+            const __m256i byte1HighTable = _mm256_setr_epi8(
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                TOO_SHORT | OVERLONG_2,
+                TOO_SHORT,
+                TOO_SHORT | OVERLONG_3 | SURROGATE,
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                TOO_SHORT | OVERLONG_2,
+                TOO_SHORT,
+                TOO_SHORT | OVERLONG_3 | SURROGATE,
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+            );
+            const __m256i byte1LowTable = _mm256_setr_epi8(
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                CARRY | OVERLONG_2,
+                CARRY,
+                CARRY,
+                CARRY | TOO_LARGE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                CARRY | OVERLONG_2,
+                CARRY,
+                CARRY,
+                CARRY | TOO_LARGE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000
+            );
+            const __m256i byte2HighTable = _mm256_setr_epi8(
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+            );
+
+            const __m256i byte1High = _mm256_shuffle_epi8(
+                    byte1HighTable, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble));
+            const __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(prev1, lowNibble));
+            const __m256i byte2High = _mm256_shuffle_epi8(
+                    byte2HighTable, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble));
+            const __m256i specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+            // 3rd and 4th bytes of a sequence must be continuations (checked through the lead byte 2 or 3 back)
+            const __m256i prev2 = prevBytes2(input, prev);
+            const __m256i prev3 = prevBytes3(input, prev);
+            const __m256i isThirdByte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            const __m256i isFourthByte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            const __m256i must23 = _mm256_and_si256(
+                    _mm256_or_si256(isThirdByte, isFourthByte), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+            return _mm256_xor_si256(must23, specialCases);
+        }
+
+        // Non-zero when the block ends in the middle of a multibyte sequence
+        GOTCHAS_TARGET("avx2")
+        inline auto isIncompleteAVX2(const __m256i input) -> __m256i {
+            const __m256i maxValue = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1)
+            );
+            return _mm256_subs_epu8(input, maxValue);
+        }
+
+        GOTCHAS_TARGET("avx2")
+        inline auto validateAVX2(const unsigned char *begin, const unsigned char *end) -> Error {
+            const unsigned char *p = begin;
+            __m256i prev = _mm256_setzero_si256();
+            __m256i prevIncomplete = _mm256_setzero_si256();
+
+            while (end - p >= 32) {
+                const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                __m256i error;
+                if (_mm256_movemask_epi8(input) == 0) {
+                    // Pure ASCII block: only an unfinished sequence from the previous block can be wrong
+                    error = prevIncomplete;
+                } else {
+                    error = checkBlockAVX2(input, prev);
+                    prevIncomplete = isIncompleteAVX2(input);
+                }
+                if (!_mm256_testz_si256(error, error)) {
+                    // Rare path: rescan from the sequence that may span the block boundary to get the exact offset
+                    return validateScalar(begin, rewindToLead(begin, p), end);
+                }
+                prev = input;
+                p += 32;
+            }
+            return validateScalar(begin, rewindToLead(begin, p), end);
+        }
+
+
+        // Bit i is set when byte i starts a sequence (is not a continuation byte)
+        GOTCHAS_TARGET("avx2")
+        inline auto leadMaskAVX2(const unsigned char *p) -> std::uint32_t {
+            const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            // Continuation bytes 80..BF are -128..-65 as signed chars
+            const __m256i isLead = _mm256_cmpgt_epi8(input, _mm256_set1_epi8(static_cast<char>(0xBF)));
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(isLead));
+        }
+
+        GOTCHAS_TARGET("sse2")
+        inline auto leadMaskSSE2(const unsigned char *p) -> std::uint32_t {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const __m128i isLead = _mm_cmpgt_epi8(input, _mm_set1_epi8(static_cast<char>(0xBF)));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(isLead));
+        }
+
+        GOTCHAS_TARGET("avx2,popcnt")
+        inline auto countAVX2(const unsigned char *p, const unsigned char *end) -> std::size_t {
+            std::size_t count = 0;
+            for (; end - p >= 32; p += 32) count += __builtin_popcount(leadMaskAVX2(p));
+            for (; p < end; ++p) count += !isContinuation(*p);
+            return count;
+        }
+
+        template<typename Allocator>
+        GOTCHAS_TARGET("avx2,bmi")
+        void splitAVX2(const std::string_view &str, std::vector<std::string_view, Allocator> &out) {
+            const unsigned char *begin = bytes(str);
+            const unsigned char *end = begin + str.size();
+            const unsigned char *p = begin;
+            std::size_t start = 0;
+
+            for (; end - p >= 32; p += 32) {
+                const std::size_t base = static_cast<std::size_t>(p - begin);
+                std::uint32_t mask = leadMaskAVX2(p);
+                if (mask == 0xFFFFFFFFu) {
+                    // Every byte starts a sequence (pure ASCII block): no bit scanning needed
+                    if (base > start) out.emplace_back(str.data() + start, base - start);
+                    for (std::size_t i = 0; i < 31; ++i) out.emplace_back(str.data() + base + i, 1);
+                    start = base + 31;
+                    continue;
+                }
+                while (mask) {
+                    const std::size_t pos = base + static_cast<std::size_t>(_tzcnt_u32(mask));
+                    if (pos > start) out.emplace_back(str.data() + start, pos - start);
+                    start = pos;
+                    mask &= mask - 1;
+                }
+            }
+            for (; p < end; ++p) {
+                const std::size_t pos = static_cast<std::size_t>(p - begin);
+                if (!isContinuation(*p) && pos > start) {
+                    out.emplace_back(str.data() + start, pos - start);
+                    start = pos;
+                }
+            }
+            if (start < str.size()) out.emplace_back(str.data() + start, str.size() - start);
+        }
+
+        template<typename Allocator>
+        GOTCHAS_TARGET("sse2")
+        void splitSSE2(const std::string_view &str, std::vector<std::string_view, Allocator> &out) {
+            const unsigned char *begin = bytes(str);
+            const unsigned char *end = begin + str.size();
+            const unsigned char *p = begin;
+            std::size_t start = 0;
+
+            for (; end - p >= 16; p += 16) {
+                const std::size_t base = static_cast<std::size_t>(p - begin);
+                std::uint32_t mask = leadMaskSSE2(p);
+                while (mask) {
+                    const std::size_t pos = base + static_cast<std::size_t>(__builtin_ctz(mask));
+                    if (pos > start) out.emplace_back(str.data() + start, pos - start);
+                    start = pos;
+                    mask &= mask - 1;
+                }
+            }
+            for (; p < end; ++p) {
+                const std::size_t pos = static_cast<std::size_t>(p - begin);
+                if (!isContinuation(*p) && pos > start) {
+                    out.emplace_back(str.data() + start, pos - start);
+                    start = pos;
+                }
+            }
+            if (start < str.size()) out.emplace_back(str.data() + start, str.size() - start);
+        }
+
+#endif
+
+        template<typename Allocator>
+        void splitScalar(const std::string_view &str, std::vector<std::string_view, Allocator> &out) {
+            std::size_t start = 0;
+            for (std::size_t i = 1; i < str.size(); ++i) {
+                if (!isContinuation(static_cast<unsigned char>(str[i]))) {
+                    out.push_back(str.substr(start, i - start));
+                    start = i;
+                }
+            }
+            if (start < str.size()) out.push_back(str.substr(start));
+        }
+
+    }
+
+
+    /**
+     * Validate the whole input.
+     *
+     * @param str UTF-8 string / string_view
+     * @return Error with status ok, or the first ill-formed sequence and its byte offset
+     */
+    [[nodiscard]] inline auto validate(const std::string_view &str) -> Error {
+        const unsigned char *begin = bytes(str);
+        const unsigned char *end = begin + str.size();
+#if defined(GOTCHAS_HAS_SIMD)
+        switch (simd::level()) {
+            case simd::Level::avx2: return detail::validateAVX2(begin, end);
+            case simd::Level::sse2: return detail::validateSSE2(begin, end);
+            default: break;
+        }
+#endif
+        return detail::validateScalar(begin, begin, end);
+    }
+
+    [[nodiscard]] inline auto isValid(const std::string_view &str) -> bool {
+        return validate(str).ok();
+    }
+
+    /**
+     * Number of code points in already validated UTF-8.
+     */
+    [[nodiscard]] inline auto countCodePoints(const std::string_view &validated) -> std::size_t {
+        const unsigned char *begin = bytes(validated);
+        const unsigned char *end = begin + validated.size();
+#if defined(GOTCHAS_HAS_SIMD)
+        if (simd::level() == simd::Level::avx2) {
+            return detail::countAVX2(begin, end);
+        }
+#endif
+        std::size_t count = 0;
+        for (const unsigned char *p = begin; p < end; ++p) count += !isContinuation(*p);
+        return count;
+    }
+
+    /**
+     * Append a view of every code point of already validated UTF-8 to `out`.
+     * Sequence boundaries are found with a vector compare + bit scan, no per-byte branching on lead bytes.
+     * Any allocator, e.g. a std::pmr::vector.
+     */
+    template<typename Allocator>
+    void appendSequences(const std::string_view &validated, std::vector<std::string_view, Allocator> &out) {
+#if defined(GOTCHAS_HAS_SIMD)
+        switch (simd::level()) {
+            case simd::Level::avx2: return detail::splitAVX2(validated, out);
+            case simd::Level::sse2: return detail::splitSSE2(validated, out);
+            default: break;
+        }
+#endif
+        detail::splitScalar(validated, out);
+    }
+
+
+    // Bytes needed to encode `cp`; invalid code points (surrogates, > U+10FFFF) are encoded as U+FFFD (3 bytes)
+    [[nodiscard]] constexpr auto encodedLength(const char32_t cp) noexcept -> std::size_t {
+        if (cp < 0x80) return 1;
+        if (cp < 0x800) return 2;
+        if (cp < 0x10000) return 3;
+        return cp < 0x110000 ? 4 : 3;
+    }
+
+    /**
+     * Encode a single code point, unchecked: `out` must have room for 4 bytes (or encodedLength(cp)).
+     * Surrogates and values above U+10FFFF are replaced with U+FFFD.
+     *
+     * @return number of bytes written, 1 to 4
+     */
+    template<typename Byte>
+    requires (sizeof(Byte) == 1)
+    constexpr auto encodeUnchecked(char32_t cp, Byte *out) noexcept -> std::size_t {
+        if (cp < 0x80) {
+            // U+0000 to U+007F, 1-byte
+            out[0] = static_cast<Byte>(cp);
+            return 1;
+        }
+        if (cp < 0x800) {
+            // U+0080 to U+07FF, 2-byte
+            out[0] = static_cast<Byte>(0xC0 | (cp >> 6));
+            out[1] = static_cast<Byte>(0x80 | (cp & 0x3F));
+            return 2;
+        }
+        if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            cp = replacementCharacter;
+        }
+        if (cp < 0x10000) {
+            // U+0800 to U+FFFF, 3-byte
+            out[0] = static_cast<Byte>(0xE0 | (cp >> 12));
+            out[1] = static_cast<Byte>(0x80 | ((cp >> 6) & 0x3F));
+            out[2] = static_cast<Byte>(0x80 | (cp & 0x3F));
+            return 3;
+        }
+        // U+10000 to U+10FFFF, 4-byte
+        out[0] = static_cast<Byte>(0xF0 | (cp >> 18));
+        out[1] = static_cast<Byte>(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<Byte>(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<Byte>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+
+    /**
+     * Encode into a caller buffer.
+     *
+     * @param cp code point
+     * @param out destination
+     * @return number of bytes written, 0 if `out` is too small (nothing is written then)
+     */
+    constexpr auto encode(const char32_t cp, const std::span<char8_t> out) noexcept -> std::size_t {
+        if (out.size() < encodedLength(cp)) {
+            return 0;
+        }
+        return encodeUnchecked(cp, out.data());
+    }
+
+    // Encode into any output iterator accepting chars, returns the advanced iterator
+    template<std::output_iterator<char> OutputIt>
+    requires (!std::same_as<OutputIt, char8_t *>) // char8_t arrays go to the bounds-checked span overload
+    constexpr auto encode(const char32_t cp, OutputIt out) -> OutputIt {
+        char buffer[4];
+        const std::size_t length = encodeUnchecked(cp, buffer);
+        for (std::size_t i = 0; i < length; ++i) *out++ = buffer[i];
+        return out;
+    }
+
+    // Append to a string, meant for strings reserved upfront (no temporaries)
+    template<typename Allocator>
+    void append(std::basic_string<char, std::char_traits<char>, Allocator> &out, const char32_t cp) {
+        char buffer[4];
+        out.append(buffer, encodeUnchecked(cp, buffer));
+    }
+
+
+
+    namespace detail {
+
+        inline auto encodedLengthScalar(const char32_t *p, const char32_t *end) -> std::size_t {
+            std::size_t length = 0;
+            for (; p < end; ++p) length += encodedLength(*p);
+            return length;
+        }
+
+        inline auto encodeScalar(const char32_t *p, const char32_t *end, unsigned char *out) -> unsigned char * {
+            for (; p < end; ++p) out += encodeUnchecked(*p, out);
+            return out;
+        }
+
+#if defined(GOTCHAS_HAS_SIMD)
+
+        // Unsigned v >= bound, per 32-bit lane
+        GOTCHAS_TARGET("avx2")
+        inline auto atLeastAVX2(const __m256i v, const int bound) -> __m256i {
+            return _mm256_cmpeq_epi32(_mm256_max_epu32(v, _mm256_set1_epi32(bound)), v);
+        }
+
+        // 1 + (cp >= 0x80) + (cp >= 0x800) + (cp >= 0x10000) - (cp >= 0x110000), 8 code points at a time
+        GOTCHAS_TARGET("avx2")
+        inline auto encodedLengthAVX2(const char32_t *p, const char32_t *end) -> std::size_t {
+            __m256i total = _mm256_setzero_si256();
+            std::size_t length = 0;
+            std::size_t pending = 0;
+            for (; end - p >= 8; p += 8) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                // Compare masks are -1, so subtracting them adds 1
+                __m256i extra = _mm256_sub_epi32(_mm256_setzero_si256(), atLeastAVX2(v, 0x80));
+                extra = _mm256_sub_epi32(extra, atLeastAVX2(v, 0x800));
+                extra = _mm256_sub_epi32(extra, atLeastAVX2(v, 0x10000));
+                extra = _mm256_add_epi32(extra, atLeastAVX2(v, 0x110000));
+                total = _mm256_add_epi32(total, extra);
+                length += 8;
+                // Flush the 32-bit lane counters long before they can overflow
+                if (++pending == (1u << 20)) {
+                    alignas(32) std::uint32_t lanes[8];
+                    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), total);
+                    for (const std::uint32_t lane : lanes) length += lane;
+                    total = _mm256_setzero_si256();
+                    pending = 0;
+                }
+            }
+            alignas(32) std::uint32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), total);
+            for (const std::uint32_t lane : lanes) length += lane;
+            return length + encodedLengthScalar(p, end);
+        }
+
+        // Blocks of 8 ASCII code points are narrowed with one shuffle, the rest is encoded scalar
+        GOTCHAS_TARGET("avx2")
+        inline auto encodeAVX2(const char32_t *p, const char32_t *end, unsigned char *out) -> unsigned char * {
+            const __m256i nonAscii = _mm256_set1_epi32(~0x7F);
+            const __m256i lowBytes = _mm256_setr_epi8(
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+            );
+            while (end - p >= 8) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                if (_mm256_testz_si256(v, nonAscii)) {
+                    const __m256i packed = _mm256_shuffle_epi8(v, lowBytes);
+                    const std::uint32_t lo = static_cast<std::uint32_t>(_mm256_extract_epi32(packed, 0));
+                    const std::uint32_t hi = static_cast<std::uint32_t>(_mm256_extract_epi32(packed, 4));
+                    std::memcpy(out, &lo, 4);
+                    std::memcpy(out + 4, &hi, 4);
+                    out += 8;
+                    p += 8;
+                } else {
+                    out = encodeScalar(p, p + 8, out);
+                    p += 8;
+                }
+            }
+            return encodeScalar(p, end, out);
+        }
+
+#endif
+
+    }
+
+    namespace detail {
+
+        // unsigned char may alias both the char storage of std::string and char8_t buffers
+        inline auto encodeBulk(const std::span<const char32_t> codePoints, unsigned char *out) -> std::size_t {
+            const char32_t *p = codePoints.data();
+            const char32_t *end = p + codePoints.size();
+#if defined(GOTCHAS_HAS_SIMD)
+            if (simd::level() == simd::Level::avx2) {
+                return static_cast<std::size_t>(encodeAVX2(p, end, out) - out);
+            }
+#endif
+            return static_cast<std::size_t>(encodeScalar(p, end, out) - out);
+        }
+
+    }
+
+    // Exact UTF-8 size of `codePoints` (vectorized with AVX2)
+    [[nodiscard]] inline auto encodedLength(const std::span<const char32_t> codePoints) -> std::size_t {
+        const char32_t *p = codePoints.data();
+#if defined(GOTCHAS_HAS_SIMD)
+        if (simd::level() == simd::Level::avx2) {
+            return detail::encodedLengthAVX2(p, p + codePoints.size());
+        }
+#endif
+        return detail::encodedLengthScalar(p, p + codePoints.size());
+    }
+
+    /**
+     * Bulk encode into a caller buffer.
+     *
+     * @param codePoints UTF-32 input
+     * @param out destination, at least encodedLength(codePoints) bytes (or 4 bytes per code point)
+     * @return number of bytes written, 0 if `out` is too small (nothing is written then)
+     */
+    inline auto encode(const std::span<const char32_t> codePoints, const std::span<char8_t> out) -> std::size_t {
+        if (out.size() < codePoints.size() * 4 && out.size() < encodedLength(codePoints)) {
+            return 0;
+        }
+        return detail::encodeBulk(codePoints, reinterpret_cast<unsigned char *>(out.data()));
+    }
+
+    /**
+     * Bulk encode: one counting pass for the exact size, one allocation, one filling pass.
+     */
+    [[nodiscard]] inline auto encode(const std::span<const char32_t> codePoints) -> std::string {
+        std::string result;
+        result.resize_and_overwrite(encodedLength(codePoints), [&](char *data, std::size_t) {
+            return detail::encodeBulk(codePoints, reinterpret_cast<unsigned char *>(data));
+        });
+        return result;
+    }
+
+
+    // Outcome of a bulk decode
+    struct DecodeResult {
+        std::size_t consumed; // input bytes
+        std::size_t written;  // output code points
+        std::size_t replaced; // maximal subparts replaced with U+FFFD
+    };
+
+    namespace detail {
+
+        inline void decodeScalar(const unsigned char *&p, const unsigned char *end, char32_t *&out,
+                                 const char32_t *outEnd, const bool final, std::size_t &replaced) {
+            while (p < end && out < outEnd) {
+                if (*p < 0x80) {
+                    *out++ = *p++;
+                    continue;
+                }
+                const Sequence seq = decodeNext(p, end);
+                if (seq.status == Status::truncated && !final) {
+                    break; // keep the incomplete tail for the next chunk
+                }
+                replaced += seq.status != Status::ok;
+                *out++ = seq.codePoint;
+                p += seq.length;
+            }
+        }
+
+#if defined(GOTCHAS_HAS_SIMD)
+
+        // 32 bytes at a time: the ASCII prefix of the block is widened with 4 zero-extending moves (vpmovzxbd),
+        // then one non-ASCII sequence is decoded scalar
+        GOTCHAS_TARGET("avx2,bmi")
+        inline void decodeAVX2(const unsigned char *&p, const unsigned char *end, char32_t *&out,
+                               const char32_t *outEnd, const bool final, std::size_t &replaced) {
+            // 3 bytes of slack: a sequence starting in the block is never truncated
+            while (end - p >= 32 + 3 && outEnd - out >= 32) {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                const auto nonAscii = static_cast<std::uint32_t>(_mm256_movemask_epi8(block));
+                if (!(nonAscii & 1)) {
+                    // ASCII first: widen all 32 bytes, keep only the ASCII prefix
+                    const __m128i lo = _mm256_castsi256_si128(block);
+                    const __m128i hi = _mm256_extracti128_si256(block, 1);
+                    auto *dst = reinterpret_cast<__m256i *>(out);
+                    _mm256_storeu_si256(dst, _mm256_cvtepu8_epi32(lo));
+                    _mm256_storeu_si256(dst + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+                    _mm256_storeu_si256(dst + 2, _mm256_cvtepu8_epi32(hi));
+                    _mm256_storeu_si256(dst + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+                    const std::size_t ascii = nonAscii ? _tzcnt_u32(nonAscii) : 32;
+                    p += ascii;
+                    out += ascii;
+                    if (!nonAscii) continue;
+                }
+
+                if (p[0] >= 0xC2 && p[0] < 0xE0 && isContinuation(p[1])) {
+                    // Inline 2-byte sequence: Latin, Greek, Cyrillic, ...
+                    *out++ = static_cast<char32_t>(((p[0] & 0x1F) << 6) | (p[1] & 0x3F));
+                    p += 2;
+                    continue;
+                }
+                const Sequence seq = decodeNext(p, end);
+                replaced += seq.status != Status::ok;
+                *out++ = seq.codePoint;
+                p += seq.length;
+            }
+            decodeScalar(p, end, out, outEnd, final, replaced);
+        }
+
+#endif
+
+    }
+
+    /**
+     * Bulk decode UTF-8 into a caller buffer.
+     * Ill-formed sequences are replaced with U+FFFD, one per maximal subpart (same as the WHATWG Encoding Standard).
+     *
+     * Streaming: with final = false an incomplete sequence at the end of `str` is not consumed,
+     * pass the remaining bytes (str.substr(result.consumed)) in front of the next chunk.
+     *
+     * @param str UTF-8 input
+     * @param out destination; decoding stops when it is full (str.size() code points are always enough)
+     * @param final true if there is no more input after `str`
+     * @return bytes consumed, code points written, number of replacements
+     */
+    inline auto decode(const std::string_view &str, const std::span<char32_t> out, const bool final = true)
+            -> DecodeResult {
+        const unsigned char *begin = bytes(str);
+        const unsigned char *p = begin;
+        char32_t *dst = out.data();
+        std::size_t replaced = 0;
+#if defined(GOTCHAS_HAS_SIMD)
+        if (simd::level() == simd::Level::avx2) {
+            detail::decodeAVX2(p, begin + str.size(), dst, out.data() + out.size(), final, replaced);
+        } else
+#endif
+        {
+            detail::decodeScalar(p, begin + str.size(), dst, out.data() + out.size(), final, replaced);
+        }
+        return {static_cast<std::size_t>(p - begin), static_cast<std::size_t>(dst - out.data()), replaced};
+    }
+
+    /**
+     * Bulk decode UTF-8 into a new UTF-32 string.
+     * The output is sized by a SIMD lead-byte count, so valid input is decoded with exactly one allocation.
+     */
+    [[nodiscard]] inline auto decode(const std::string_view &str) -> std::u32string {
+        std::u32string result;
+        std::string_view rest = str;
+        std::size_t capacity = countCodePoints(str);
+        while (true) {
+            const std::size_t offset = result.size();
+            result.resize_and_overwrite(offset + capacity, [&](char32_t *data, std::size_t) {
+                const DecodeResult decoded = decode(rest, std::span(data + offset, capacity));
+                rest.remove_prefix(decoded.consumed);
+                return offset + decoded.written;
+            });
+            if (rest.empty()) break;
+            // Ill-formed input may produce more code points than lead bytes, one per byte at most
+            capacity = rest.size();
+        }
+        return result;
+    }
+
+
+    /**
+     * Lazy forward view over the sequences of a UTF-8 string, decoded one at a time on increment.
+     * Nothing is allocated, so it composes with std::views::take / transform etc. on inputs of any size.
+     *
+     * Ill-formed input never throws: each maximal subpart is yielded as its own element
+     * (the raw bytes for Element = std::string_view, U+FFFD for Element = char32_t).
+     *
+     * @tparam Element std::string_view (sequence bytes) or char32_t (decoded code point)
+     */
+    template<typename Element>
+    requires std::same_as<Element, std::string_view> || std::same_as<Element, char32_t>
+    class View : public std::ranges::view_interface<View<Element>> {
+    public:
+        class Iterator {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Element;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(const unsigned char *pos, const unsigned char *end) : pos_(pos), end_(end) {
+                decode();
+            }
+
+            [[nodiscard]] auto operator*() const -> Element {
+                if constexpr (std::same_as<Element, char32_t>) {
+                    return current_.codePoint;
+                } else {
+                    return {reinterpret_cast<const char *>(pos_), current_.length};
+                }
+            }
+
+            auto operator++() -> Iterator & {
+                pos_ += current_.length;
+                decode();
+                return *this;
+            }
+
+            auto operator++(int) -> Iterator {
+                Iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            // Status of the current element (ok, or why it was replaced)
+            [[nodiscard]] auto status() const noexcept -> Status { return current_.status; }
+            // Byte position of the current element
+            [[nodiscard]] auto base() const noexcept -> const char * { return reinterpret_cast<const char *>(pos_); }
+
+            [[nodiscard]] friend auto operator==(const Iterator &a, const Iterator &b) noexcept -> bool {
+                return a.pos_ == b.pos_;
+            }
+            [[nodiscard]] friend auto operator==(const Iterator &it, std::default_sentinel_t) noexcept -> bool {
+                return it.pos_ == it.end_;
+            }
+
+        private:
+            void decode() {
+                if (pos_ != end_) current_ = decodeNext(pos_, end_);
+            }
+
+            const unsigned char *pos_ = nullptr;
+            const unsigned char *end_ = nullptr;
+            Sequence current_{0, 0, Status::ok};
+        };
+
+        View() = default;
+        explicit View(const std::string_view &str) : str_(str) {}
+
+        [[nodiscard]] auto begin() const -> Iterator { return {bytes(str_), bytes(str_) + str_.size()}; }
+        [[nodiscard]] auto end() const noexcept -> std::default_sentinel_t { return std::default_sentinel; }
+
+        // Underlying bytes
+        [[nodiscard]] auto base() const noexcept -> std::string_view { return str_; }
+
+    private:
+        std::string_view str_;
+    };
+
+    using SequenceView = View<std::string_view>;
+    using CodePointView = View<char32_t>;
+
+    // for (std::string_view seq : utf8::sequences(str)) ...
+    [[nodiscard]] inline auto sequences(const std::string_view &str) -> SequenceView {
+        return SequenceView{str};
+    }
+
+    // for (char32_t cp : utf8::codePoints(str)) ...
+    [[nodiscard]] inline auto codePoints(const std::string_view &str) -> CodePointView {
+        return CodePointView{str};
+    }
+
+    namespace views {
+
+        // Pipeable adaptors: str | utf8::views::codePoints | std::views::take(3)
+        template<typename ViewType>
+        struct Adaptor {
+            [[nodiscard]] auto operator()(const std::string_view &str) const -> ViewType { return ViewType{str}; }
+
+            [[nodiscard]] friend auto operator|(const std::string_view &str, const Adaptor &adaptor) -> ViewType {
+                return adaptor(str);
+            }
+        };
+
+        inline constexpr Adaptor<SequenceView> sequences{};
+        inline constexpr Adaptor<CodePointView> codePoints{};
+
+    }
+
+}
+
+// Views only reference the input, iterators stay valid after the view itself is gone
+template<typename Element>
+inline constexpr bool std::ranges::enable_borrowed_range<utf8::View<Element>> = true;
@@ -0,0 +1,216 @@
+/**
+ * variadic_print
+ *
+ * print(1, "two", 3.14f, false) → "1, two, 3.14, 0\n" with one write() call, instead of a stream
+ * operation per argument and a flush (the recursive print in variadic_template.cpp), with the same text.
+ *
+ *  - the maximal text length of each argument type is known at compile time: integers (digits10 + sign),
+ *    floating point (6 significant digits), bool, chars, string literals and char arrays (up to the first
+ *    NUL, or the whole array when it has none). When all the arguments are of such types, the line is
+ *    rendered into a std::array of exactly that size on the stack, if it's at most 1 KB
+ *  - std::string, std::string_view and const char * add their runtime length: a 1 KB stack buffer, or a
+ *    heap buffer only for longer lines (and for large char arrays)
+ *  - any other type with operator<< goes through a std::ostringstream first
+ *  - numbers are written with std::to_chars and the stream defaults, without a locale: 6 significant digits,
+ *    bools as 1 / 0; char, signed char and unsigned char as a character, as operator<< does
+ *
+ * The FILE is flushed first, so the order with printf and std::cout (synced with stdio by default) is kept.
+ *
+ * Usage:
+ *  variadic::print(1, "two", 3.14f, false);
+ *  variadic::printTo(stderr, "error", errno);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <unistd.h>
+
+
+namespace variadic {
+
+    namespace detail {
+
+        inline constexpr std::size_t unbounded = std::numeric_limits<std::size_t>::max();
+        inline constexpr std::size_t stackSize = 1024;
+        inline constexpr std::string_view separator = ", ";
+
+        template<typename T>
+        concept CharArray = std::is_array_v<T> && std::same_as<std::remove_cv_t<std::remove_extent_t<T>>, char>;
+
+        // Printed as a character, like std::cout << value
+        template<typename T>
+        concept Character = std::same_as<T, char> || std::same_as<T, signed char> || std::same_as<T, unsigned char>;
+
+        template<typename T>
+        concept Text = !CharArray<T> && std::convertible_to<const T &, std::string_view>;
+
+        // Maximal text length of any value of type T, or unbounded
+        template<typename T>
+        [[nodiscard]] consteval auto maxSize() -> std::size_t {
+            if constexpr (std::same_as<T, bool>) {
+                return 1;
+            } else if constexpr (Character<T>) {
+                return 1;
+            } else if constexpr (std::integral<T>) {
+                return std::numeric_limits<T>::digits10 + 2;
+            } else if constexpr (std::floating_point<T>) {
+                // Sign, 6 digits, point, "e-" and up to 4 exponent digits
+                return 14;
+            } else if constexpr (CharArray<T>) {
+                // The whole array: a buffer filled up to its last byte has no NUL
+                return std::extent_v<T>;
+            } else {
+                return unbounded;
+            }
+        }
+
+        template<typename... Args>
+        inline constexpr bool bounded = ((maxSize<Args>() != unbounded) && ...);
+
+        // Separators and the newline
+        template<typename... Args>
+        inline constexpr std::size_t punctuation = sizeof...(Args) == 0 ? 1 : separator.size() * (sizeof...(Args) - 1) + 1;
+
+        // A char array holds a literal or a NUL-terminated buffer: up to the first NUL, or the whole array
+        template<CharArray T>
+        [[nodiscard]] auto view(const T &value) noexcept -> std::string_view {
+            return {value, static_cast<std::size_t>(std::find(value, value + std::extent_v<T>, '\0') - value)};
+        }
+
+        template<typename T>
+        [[nodiscard]] auto textSize(const T &value) -> std::size_t {
+            if constexpr (maxSize<T>() != unbounded) {
+                return maxSize<T>();
+            } else {
+                return std::string_view(value).size();
+            }
+        }
+
+        // Pass numbers, bools, chars and strings through, everything else becomes a std::string
+        template<typename T>
+        [[nodiscard]] auto prepare(const T &value) -> decltype(auto) {
+            if constexpr (maxSize<T>() != unbounded || Text<T>) {
+                return (value);
+            } else {
+                std::ostringstream stream;
+                stream << value;
+                return std::move(stream).str();
+            }
+        }
+
+        template<typename T>
+        [[nodiscard]] auto append(char *out, const T &value) noexcept -> char * {
+            if constexpr (std::same_as<T, bool>) {
+                *out = value ? '1' : '0';
+                return out + 1;
+            } else if constexpr (Character<T>) {
+                *out = static_cast<char>(value);
+                return out + 1;
+            } else if constexpr (std::integral<T>) {
+                // Through (unsigned) long long: std::to_chars has no overload for wchar_t, char8_t...
+                using Wide = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
+                return std::to_chars(out, out + maxSize<T>(), static_cast<Wide>(value)).ptr;
+            } else if constexpr (std::floating_point<T>) {
+                // Like operator<< with the default precision
+                return std::to_chars(out, out + maxSize<T>(), value, std::chars_format::general, 6).ptr;
+            } else {
+                std::string_view text;
+                if constexpr (CharArray<T>) {
+                    text = view(value);
+                } else {
+                    text = value;
+                }
+                std::memcpy(out, text.data(), text.size());
+                return out + text.size();
+            }
+        }
+
+        // Arguments joined with ", " and a newline; `out` has room for the sum of textSize(args) and punctuation
+        inline auto render(char *out) noexcept -> char * {
+            *out++ = '\n';
+            return out;
+        }
+
+        template<typename First, typename... Rest>
+        auto render(char *out, const First &first, const Rest &...rest) noexcept -> char * {
+            out = append(out, first);
+            ((out = std::copy(separator.begin(), separator.end(), out), out = append(out, rest)), ...);
+            *out++ = '\n';
+            return out;
+        }
+
+        // One write() for the whole line, retrying short writes and EINTR
+        inline void write(std::FILE *file, const char *p, std::size_t left) {
+            if (std::fflush(file) != 0) throw std::system_error(errno, std::generic_category(), "variadic::print");
+            const int fd = ::fileno(file);
+            while (left > 0) {
+                const ::ssize_t written = ::write(fd, p, left);
+                if (written <= 0) {
+                    if (written < 0 && errno == EINTR) continue;
+                    // 0 bytes with data left: no progress is possible, don't spin
+                    throw std::system_error(written < 0 ? errno : EIO, std::generic_category(), "variadic::print");
+                }
+                p += written;
+                left -= static_cast<std::size_t>(written);
+            }
+        }
+
+        template<typename... Args>
+        void print(std::FILE *file, const Args &...args) {
+            if constexpr (bounded<Args...> && (maxSize<Args>() + ... + 0) + punctuation<Args...> <= stackSize) {
+                std::array<char, (maxSize<Args>() + ... + 0) + punctuation<Args...>> buffer;
+                const char *end = render(buffer.data(), args...);
+                write(file, buffer.data(), static_cast<std::size_t>(end - buffer.data()));
+            } else {
+                const std::size_t capacity = (textSize(args) + ... + 0) + punctuation<Args...>;
+                if (capacity <= stackSize) {
+                    std::array<char, stackSize> buffer;
+                    const char *end = render(buffer.data(), args...);
+                    write(file, buffer.data(), static_cast<std::size_t>(end - buffer.data()));
+                } else {
+                    std::string buffer;
+                    buffer.resize_and_overwrite(capacity, [&](char *data, std::size_t) {
+                        return static_cast<std::size_t>(render(data, args...) - data);
+                    });
+                    write(file, buffer.data(), buffer.size());
+                }
+            }
+        }
+
+    }
+
+
+    /**
+     * Write the arguments separated by ", " and followed by a newline, with a single write().
+     *
+     * @param file output, flushed first
+     * @param args numbers, bools, chars, strings, or anything with operator<<
+     * @throws std::system_error if the output can't be written
+     */
+    template<typename... Args>
+    void printTo(std::FILE *file, const Args &...args) {
+        detail::print(file, detail::prepare(args)...);
+    }
+
+    // To stdout
+    template<typename... Args>
+    void print(const Args &...args) {
+        printTo(stdout, args...);
+    }
+
+}
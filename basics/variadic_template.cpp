@@ -1,5 +1,7 @@
 #include <iostream>
 
+#include "variadic_print.hpp"
+
 template<typename T>
 void print(T value) {
     std::cout << value << std::endl;
@@ -11,8 +13,20 @@ void print(T value, Args... args) {
     print(args...);
 }
 
-// g++ -std=c++11 variadic_template.cpp -o /tmp/variadic_template && /tmp/variadic_template
+// g++ -std=c++23 variadic_template.cpp -o /tmp/variadic_template && /tmp/variadic_template
 int main() {
+    // 1, two, 3.14, 0: a stream operation per argument and a flush
     print(1, "two", 3.14f, false);
+
+    // 1, two, 3.14, 0: same text, rendered into one stack buffer sized at compile time, one write() (variadic_print.hpp)
+    variadic::print(1, "two", 3.14f, false);
+
+    // abc, A, B: a char array without a NUL is printed whole (std::cout << raw would read past it),
+    // signed char and unsigned char as characters like print(a, b) does
+    const char raw[3] = {'a', 'b', 'c'};
+    const signed char a = 'A';
+    const unsigned char b = 'B';
+    print(a, b);
+    variadic::print(raw, a, b);
     return 0;
 }
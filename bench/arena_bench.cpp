@@ -0,0 +1,106 @@
+/**
+ * arena_bench
+ *
+ * Per-request string work from basics/strings.hpp: split a CSV record into fields, case-map every field,
+ * split the record into code points and re-encode its UTF-32 form. With the std::string / std::vector
+ * overloads (global heap) and with the std::pmr overloads on an arena::Arena reset after each request
+ * (basics/arena.hpp). Reports ns per request, MB/s of record text, and heap allocations per request
+ * (global operator new is counted).
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../basics/arena.hpp"
+#include "../basics/strings.hpp"
+#include "bench.hpp"
+
+
+std::atomic<std::size_t> allocations{0};
+
+void *operator new(const std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+// std::pmr::new_delete_resource() asks for the alignment explicitly
+void *operator new(const std::size_t size, const std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+
+[[nodiscard]] auto heapRequest(const std::string_view record, const std::u32string &wide) -> std::size_t {
+    std::size_t size = 0;
+    for (const std::string_view field : splitString(record, ',')) {
+        size += toUpperCase(field).size() + toLower(std::string(field)).size();
+    }
+    size += splitIntoCodePoints(record).size();
+    size += encodeUTF8(wide).size();
+    return size;
+}
+
+[[nodiscard]] auto arenaRequest(const std::string_view record, const std::u32string &wide, arena::Arena &arena)
+        -> std::size_t {
+    std::pmr::memory_resource *resource = arena.resource();
+    std::size_t size = 0;
+    for (const std::string_view field : splitString(record, ',', resource)) {
+        size += toUpperCase(field, resource).size() + toLower(field, resource).size();
+    }
+    size += splitIntoCodePoints(record, resource).size();
+    size += encodeUTF8(wide, resource).size();
+    arena.reset();
+    return size;
+}
+
+template<typename Fn>
+[[nodiscard]] auto countAllocations(Fn &&fn) -> std::size_t {
+    const std::size_t before = allocations.load(std::memory_order_relaxed);
+    bench::doNotOptimize(fn());
+    return allocations.load(std::memory_order_relaxed) - before;
+}
+
+void compare(const std::string_view title, const std::string &record) {
+    const std::u32string wide = decodeUTF8(record);
+    arena::Arena arena;
+
+    bench::header(std::format("{}, {} bytes per request", title, record.size()));
+    bench::run("std::string / std::vector", record.size(), [&] { return heapRequest(record, wide); });
+    bench::run("std::pmr on arena::Arena, reset per request", record.size(), [&] {
+        return arenaRequest(record, wide, arena);
+    });
+    std::cout << std::format("{:<48} {:>14}\n", "heap allocations per request, std", countAllocations([&] {
+        return heapRequest(record, wide);
+    }));
+    std::cout << std::format("{:<48} {:>14}\n", "heap allocations per request, arena", countAllocations([&] {
+        return arenaRequest(record, wide, arena);
+    }));
+}
+
+// g++ -std=c++23 -O2 arena_bench.cpp -o /tmp/arena_bench && /tmp/arena_bench
+int main() {
+    std::string small = "get,/api/v1/users,200,application/json,gzip,keep-alive,Mozilla/5.0 (X11; Linux x86_64),ru-RU";
+    std::string large;
+    for (int i = 0; i < 200; ++i) {
+        large += std::format("{},name {},Straße {},привет мир,早安 🐳,", i, i * 7, i % 13);
+    }
+    compare("8-field record", small);
+    compare("1000-field record", large);
+    return 0;
+}
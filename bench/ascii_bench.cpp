@@ -0,0 +1,66 @@
+/**
+ * ascii_bench
+ *
+ * ASCII case conversion: copy + std::tolower per byte vs the SIMD kernel (copy, in place, caller buffer),
+ * on a large text and on short HTTP header names.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "../basics/strings.hpp"
+#include "bench.hpp"
+
+
+// The previous implementation
+[[nodiscard]] auto toLowerLocale(const std::string &str) -> std::string {
+    std::string result = str;
+    std::ranges::transform(result, result.begin(), [](const unsigned char c) { return std::tolower(c); });
+    return result;
+}
+
+// g++ -std=c++23 -O2 ascii_bench.cpp -o /tmp/ascii_bench && /tmp/ascii_bench
+int main() {
+    const std::string text = bench::repeat("The Quick Brown Fox Jumps Over The Lazy Dog. HTTP/1.1 200 OK ", 1024 * 1024);
+
+    bench::header(std::format("{} KB text", text.size() >> 10));
+    bench::run("copy + std::tolower per byte", text.size(), [&] { return toLowerLocale(text); });
+    bench::run("toLower(const std::string &)", text.size(), [&] { return toLower(text); });
+    std::string inPlace = text;
+    bench::run("toLower(std::span<char>) in place", text.size(), [&] { toLower(std::span<char>(inPlace)); });
+    std::string buffer(text.size(), '\0');
+    bench::run("toLower(string_view, buffer)", text.size(), [&] { return toLower(text, buffer); });
+
+    const std::vector<std::string> headers = {
+        "Content-Type", "Content-Length", "Accept-Encoding", "User-Agent", "X-Forwarded-For", "Cache-Control",
+        "Host", "Connection", "Authorization", "If-None-Match", "Access-Control-Allow-Origin", "ETag",
+    };
+    std::size_t headerBytes = 0;
+    for (const std::string &header : headers) headerBytes += header.size();
+
+    bench::header("HTTP header names");
+    bench::run("copy + std::tolower per byte", headerBytes, [&] {
+        std::size_t total = 0;
+        for (const std::string &header : headers) total += toLowerLocale(header).size();
+        return total;
+    });
+    bench::run("toLower(std::string(header)) moved", headerBytes, [&] {
+        std::size_t total = 0;
+        for (const std::string &header : headers) total += toLower(std::string(header)).size();
+        return total;
+    });
+    bench::run("toLower(header, char[64])", headerBytes, [&] {
+        std::array<char, 64> key;
+        std::size_t total = 0;
+        for (const std::string &header : headers) {
+            total += toLower(header, key);
+            bench::doNotOptimize(key.data());
+        }
+        return total;
+    });
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * async_log_bench
+ *
+ * Cost of one console::log call as seen by the calling thread, with 1 to 32 threads logging at once:
+ * synchronous (std::endl, a mutex for whole lines) vs AsyncLogger with the block and drop overflow policies.
+ * Output goes to a file in the temp directory. Reports p50 / p99 / p99.9 call latency and the dropped records.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../concepts/async_log.hpp"
+
+
+constexpr std::size_t callsPerThread = 20'000;
+
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream &operator<<(std::ostream &out, const Point &point) {
+    return out << "Point { x: " << point.x << ", y: " << point.y << " }";
+}
+
+// Run `call(thread, i)` on `threads` threads, return the sorted latencies of all calls in ns
+template<typename Call>
+auto measure(const std::size_t threads, Call &&call) -> std::vector<double> {
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::vector<double>> latencies(threads);
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t thread = 0; thread < threads; ++thread) {
+            workers.emplace_back([&, thread] {
+                std::vector<double> &own = latencies[thread];
+                own.reserve(callsPerThread);
+                for (std::size_t i = 0; i < callsPerThread; ++i) {
+                    const auto start = Clock::now();
+                    call(thread, i);
+                    own.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+                }
+            });
+        }
+    }
+    std::vector<double> all;
+    for (const auto &own : latencies) all.insert(all.end(), own.begin(), own.end());
+    std::ranges::sort(all);
+    return all;
+}
+
+void report(const std::string_view name, const std::vector<double> &sorted, const std::uint64_t dropped = 0) {
+    const auto percentile = [&](const double p) {
+        return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(p * static_cast<double>(sorted.size())))];
+    };
+    std::cout << std::format("{:<32} {:>10.0f} {:>10.0f} {:>10.0f} {:>10}\n",
+                             name, percentile(0.5), percentile(0.99), percentile(0.999), dropped);
+}
+
+// g++ -std=c++23 -O2 -pthread async_log_bench.cpp -o /tmp/async_log_bench && /tmp/async_log_bench
+int main() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "async_log_bench.log";
+    const auto print = [](std::ostream &out, const auto &...values) { (out << ... << values); };
+
+    for (const std::size_t threads : {1, 2, 4, 8, 16, 32}) {
+        std::cout << std::format("\n## {} threads, {} calls each\n", threads, callsPerThread);
+        std::cout << std::format("{:<32} {:>10} {:>10} {:>10} {:>10}\n", "ns per call", "p50", "p99", "p99.9", "dropped");
+
+        {
+            std::ofstream out(path);
+            std::mutex mutex;
+            report("sync, std::endl", measure(threads, [&](const std::size_t thread, const std::size_t i) {
+                const std::lock_guard lock(mutex);
+                out << "Thread " << thread << ", call " << i << ": " << Point{3, 4} << std::endl;
+            }));
+        }
+
+        for (const auto overflow : {AsyncLogger::Overflow::block, AsyncLogger::Overflow::drop}) {
+            std::ofstream out(path);
+            AsyncLogger logger(out, {.overflow = overflow});
+            const auto sorted = measure(threads, [&](const std::size_t thread, const std::size_t i) {
+                logger.log(print, "Thread ", thread, ", call ", i, ": ", Point{3, 4});
+            });
+            logger.flush();
+            report(overflow == AsyncLogger::Overflow::block ? "AsyncLogger, block" : "AsyncLogger, drop",
+                   sorted, logger.dropped());
+        }
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
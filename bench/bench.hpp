@@ -0,0 +1,306 @@
+/**
+ * bench
+ *
+ * Tiny dependency-free micro-benchmark helper: warmup, calibrated batches, median and percentiles of the time
+ * per operation, hardware counters and a JSON report.
+ *
+ *  - warmup + calibration: the iteration count doubles until a batch takes options.minBatchTime
+ *  - then options.batches batches: min, median, p90 and max of the time per operation over the batches
+ *  - on Linux, cycles, instructions, cache misses and branch misses per operation from perf_event_open(),
+ *    user space only (works with the default perf_event_paranoid = 2). Shown as "-" when not available, e.g.
+ *    in most containers and VMs. BENCH_COUNTERS=0 turns them off
+ *  - with BENCH_JSON=path in the environment, every result is written to that file as JSON at exit, for
+ *    tracking regressions across commits (cmake --build . --target run_benchmarks, see CMakeLists.txt)
+ *
+ * Usage:
+ *  bench::header();
+ *  bench::run("toUpperCase", input.size(), [&] { return toUpperCase(input); });
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace bench {
+
+    // Keep the compiler from optimizing away a result
+    template<typename T>
+    inline void doNotOptimize(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // A sample repeated up to at least `size` bytes, as benchmark input
+    [[nodiscard]] inline auto repeat(const std::string_view sample, const std::size_t size) -> std::string {
+        std::string result;
+        result.reserve(size + sample.size());
+        while (result.size() < size) result += sample;
+        return result;
+    }
+
+    // Per operation
+    struct Counters {
+        double cycles;
+        double instructions;
+        double cacheMisses;
+        double branchMisses;
+    };
+
+    struct Result {
+        std::string name;
+        double nsPerOp;  // median over the batches
+        double mbPerSec; // 0 when bytesPerOp is 0
+        double minNs = 0;
+        double p90Ns = 0;
+        double maxNs = 0;
+        std::size_t iterations = 0; // per batch
+        std::optional<Counters> counters{};
+        std::string group{};        // title of the last header()
+    };
+
+    struct Options {
+        std::size_t batches = 7;
+        std::chrono::nanoseconds minBatchTime = std::chrono::milliseconds(20);
+    };
+
+
+    namespace detail {
+
+        // Nearest rank, `sorted` is not empty
+        [[nodiscard]] inline auto percentile(const std::vector<double> &sorted, const double p) -> double {
+            const auto rank = static_cast<std::size_t>(std::ceil(p / 100 * static_cast<double>(sorted.size())));
+            return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+        }
+
+        [[nodiscard]] inline auto escape(const std::string_view text) -> std::string {
+            std::string result;
+            for (const char c : text) {
+                if (c == '"' || c == '\\') {
+                    result += '\\';
+                    result += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    result += std::format("\\u{:04x}", static_cast<unsigned>(c));
+                } else {
+                    result += c;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * The four hardware counters of this thread, each opened on its own (not as a group) so that one
+         * missing event doesn't disable the others. Counts are scaled when the kernel multiplexes them.
+         */
+        class PerfCounters {
+        public:
+#if defined(__linux__)
+            PerfCounters() {
+                const char *enabled = std::getenv("BENCH_COUNTERS");
+                if (enabled != nullptr && std::string_view(enabled) == "0") return;
+                constexpr std::array<std::uint64_t, 4> events{
+                    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+                };
+                for (std::size_t i = 0; i < events.size(); ++i) {
+                    perf_event_attr attr{};
+                    attr.type = PERF_TYPE_HARDWARE;
+                    attr.size = sizeof(attr);
+                    attr.config = events[i];
+                    attr.disabled = 1;
+                    attr.exclude_kernel = 1;
+                    attr.exclude_hv = 1;
+                    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                    fds_[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                }
+            }
+
+            ~PerfCounters() {
+                for (const int fd : fds_) {
+                    if (fd >= 0) ::close(fd);
+                }
+            }
+
+            [[nodiscard]] auto available() const noexcept -> bool {
+                return std::ranges::any_of(fds_, [](const int fd) { return fd >= 0; });
+            }
+
+            void start() noexcept {
+                for (const int fd : fds_) {
+                    if (fd < 0) continue;
+                    ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+
+            // Totals since start(), NaN for the events that couldn't be opened
+            [[nodiscard]] auto stop() noexcept -> std::array<double, 4> {
+                std::array<double, 4> totals{};
+                for (std::size_t i = 0; i < fds_.size(); ++i) {
+                    totals[i] = std::nan("");
+                    if (fds_[i] < 0) continue;
+                    ::ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+                    std::uint64_t values[3]; // value, time enabled, time running
+                    if (::read(fds_[i], values, sizeof(values)) != sizeof(values) || values[2] == 0) continue;
+                    totals[i] = static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+                }
+                return totals;
+            }
+
+        private:
+            std::array<int, 4> fds_{-1, -1, -1, -1};
+#else
+            [[nodiscard]] auto available() const noexcept -> bool { return false; }
+            void start() noexcept {}
+            [[nodiscard]] auto stop() noexcept -> std::array<double, 4> { return {}; }
+#endif
+        };
+
+        [[nodiscard]] inline auto perfCounters() -> PerfCounters & {
+            static PerfCounters counters;
+            return counters;
+        }
+
+        // Every result of the process, written as JSON to $BENCH_JSON at exit
+        class Report {
+        public:
+            ~Report() {
+                const char *path = std::getenv("BENCH_JSON");
+                if (path == nullptr || *path == '\0') return;
+                std::ofstream out(path);
+                write(out);
+                if (!out) std::cerr << std::format("bench: failed writing {}\n", path);
+            }
+
+            void add(Result result) { results_.push_back(std::move(result)); }
+
+            std::string group;
+
+        private:
+            void write(std::ostream &out) const {
+                const auto number = [](const double value) {
+                    return std::isfinite(value) ? std::format("{:.3f}", value) : std::string("null");
+                };
+                out << "{\n  \"compiler\": \"" << escape(__VERSION__) << "\",\n  \"benchmarks\": [";
+                for (std::size_t i = 0; i < results_.size(); ++i) {
+                    const Result &r = results_[i];
+                    out << (i ? ",\n" : "\n") << std::format(
+                        "    {{\"group\": \"{}\", \"name\": \"{}\", \"iterations\": {}, "
+                        "\"ns_per_op\": {{\"min\": {}, \"median\": {}, \"p90\": {}, \"max\": {}}}, \"mb_per_sec\": {}, ",
+                        escape(r.group), escape(r.name), r.iterations,
+                        number(r.minNs), number(r.nsPerOp), number(r.p90Ns), number(r.maxNs), number(r.mbPerSec));
+                    if (r.counters) {
+                        out << std::format(
+                            "\"counters\": {{\"cycles\": {}, \"instructions\": {}, \"cache_misses\": {}, \"branch_misses\": {}}}}}",
+                            number(r.counters->cycles), number(r.counters->instructions),
+                            number(r.counters->cacheMisses), number(r.counters->branchMisses));
+                    } else {
+                        out << "\"counters\": null}";
+                    }
+                }
+                out << "\n  ]\n}\n";
+            }
+
+            std::vector<Result> results_;
+        };
+
+        inline Report report;
+
+        [[nodiscard]] inline auto cell(const double value, const int precision) -> std::string {
+            return std::isfinite(value) ? std::format("{:.{}f}", value, precision) : std::string("-");
+        }
+
+    }
+
+
+    inline void header(const std::string_view title = "") {
+        detail::report.group = title;
+        if (!title.empty()) std::cout << std::format("\n## {}\n", title);
+        std::cout << std::format("{:<48} {:>14} {:>12} {:>12} {:>12} {:>6}\n",
+                                 "benchmark", "ns/op", "MB/s", "p90 ns/op", "instr/op", "IPC");
+    }
+
+    /**
+     * Measure `fn`, print one row and return the result.
+     *
+     * @param name label
+     * @param bytesPerOp input bytes processed by one call, for throughput
+     * @param fn callable, its return value (if any) is kept alive
+     * @param options batch count and minimal batch duration
+     */
+    template<typename Fn>
+    auto run(const std::string_view name, const std::size_t bytesPerOp, Fn &&fn, const Options options = {})
+            -> Result {
+        using Clock = std::chrono::steady_clock;
+
+        const auto call = [&fn] {
+            if constexpr (std::is_void_v<decltype(fn())>) {
+                fn();
+            } else {
+                doNotOptimize(fn());
+            }
+        };
+
+        // Warmup + calibration: double iterations until a batch is long enough
+        std::size_t iterations = 1;
+        while (true) {
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) call();
+            if (Clock::now() - start >= options.minBatchTime || iterations >= (1u << 30)) break;
+            iterations *= 2;
+        }
+
+        detail::PerfCounters &perf = detail::perfCounters();
+        std::vector<double> samples;
+        samples.reserve(options.batches);
+        perf.start();
+        for (std::size_t batch = 0; batch < options.batches; ++batch) {
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) call();
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            samples.push_back(elapsed.count() / static_cast<double>(iterations));
+        }
+        const std::array<double, 4> totals = perf.stop();
+        std::ranges::sort(samples);
+        const double median = samples[samples.size() / 2];
+
+        Result result{std::string(name), median, bytesPerOp ? static_cast<double>(bytesPerOp) * 1e3 / median : 0};
+        result.minNs = samples.front();
+        result.p90Ns = detail::percentile(samples, 90);
+        result.maxNs = samples.back();
+        result.iterations = iterations;
+        result.group = detail::report.group;
+        if (perf.available()) {
+            const double operations = static_cast<double>(iterations * options.batches);
+            result.counters = Counters{totals[0] / operations, totals[1] / operations,
+                                       totals[2] / operations, totals[3] / operations};
+        }
+
+        const double instructions = result.counters ? result.counters->instructions : std::nan("");
+        const double ipc = result.counters ? result.counters->instructions / result.counters->cycles : std::nan("");
+        std::cout << std::format("{:<48} {:>14.1f} {:>12.1f} {:>12.1f} {:>12} {:>6}\n", result.name, result.nsPerOp,
+                                 result.mbPerSec, result.p90Ns, detail::cell(instructions, 0), detail::cell(ipc, 2));
+        detail::report.add(result);
+        return result;
+    }
+
+}
@@ -0,0 +1,100 @@
+/**
+ * binary_log_bench
+ *
+ * One event record (ints, a double, a short string and an IntOrString-like variant), logged as text
+ * (std::ofstream, '\n'), through AsyncLogger and into a binary log: ns per call and log file size.
+ * Then the cost of decoding the binary log back to text.
+ *
+ * Calls in a tight loop measure the sustained rate: once AsyncLogger's ring is full, each call waits for the
+ * background thread, which does all the formatting (see async_log_bench.cpp for the latency of bursts).
+ * The size ratio depends on how much constant text the messages have, this one is mostly arguments.
+ */
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <variant>
+
+#include "../concepts/async_log.hpp"
+#include "../concepts/binary_log.hpp"
+#include "../file_read/mapped_file.hpp"
+#include "bench.hpp"
+
+
+using IntOrString = std::variant<int, std::string>;
+
+std::ostream &operator<<(std::ostream &out, const IntOrString &value) {
+    std::visit([&out](const auto &v) { out << v; }, value);
+    return out;
+}
+
+constexpr std::size_t eventCount = 1'000'000;
+
+// g++ -std=c++23 -O2 -pthread binary_log_bench.cpp -o /tmp/binary_log_bench && /tmp/binary_log_bench
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string user = "alice";
+    const IntOrString keys[] = {42, std::string("order-17")};
+    const auto print = [](std::ostream &out, const auto &...values) { (out << ... << values); };
+
+    bench::header("ns per log call");
+    {
+        std::ofstream out(directory / "binary_log_bench.txt");
+        std::size_t i = 0;
+        bench::run("std::ofstream, '\\n'", 0, [&] {
+            ++i;
+            out << "event " << i << " user " << user << " amount " << 0.01 * static_cast<double>(i % 10'000)
+                << " key " << keys[i & 1] << " flags " << (i & 0xFF) << '\n';
+        });
+    }
+    {
+        std::ofstream out(directory / "binary_log_bench.txt");
+        AsyncLogger logger(out);
+        std::size_t i = 0;
+        bench::run("AsyncLogger", 0, [&] {
+            ++i;
+            logger.log(print, "event ", i, " user ", user, " amount ", 0.01 * static_cast<double>(i % 10'000),
+                       " key ", keys[i & 1], " flags ", i & 0xFF);
+        });
+    }
+    {
+        binlog::Writer writer(directory / "binary_log_bench.binlog");
+        std::size_t i = 0;
+        bench::run("binlog::log", 0, [&] {
+            ++i;
+            binlog::log<"event {} user {} amount {} key {} flags {}">(
+                writer, i, user, 0.01 * static_cast<double>(i % 10'000), keys[i & 1], i & 0xFF);
+        });
+    }
+
+    // Same events, fixed count, for the file sizes
+    {
+        std::ofstream text(directory / "binary_log_bench.txt");
+        binlog::Writer writer(directory / "binary_log_bench.binlog");
+        for (std::size_t i = 1; i <= eventCount; ++i) {
+            text << "event " << i << " user " << user << " amount " << 0.01 * static_cast<double>(i % 10'000)
+                 << " key " << keys[i & 1] << " flags " << (i & 0xFF) << '\n';
+            binlog::log<"event {} user {} amount {} key {} flags {}">(
+                writer, i, user, 0.01 * static_cast<double>(i % 10'000), keys[i & 1], i & 0xFF);
+        }
+        writer.close();
+    }
+    const std::size_t textSize = std::filesystem::file_size(directory / "binary_log_bench.txt");
+    const std::size_t binarySize = std::filesystem::file_size(directory / "binary_log_bench.binlog");
+    std::cout << std::format("\n{} events: text {} bytes, binary {} bytes ({:.1f}x smaller)\n",
+                             eventCount, textSize, binarySize, static_cast<double>(textSize) / static_cast<double>(binarySize));
+
+    const MappedFile binary(directory / "binary_log_bench.binlog");
+    bench::header("decode, per log file");
+    bench::run("binlog::decode", binary.size(), [&] {
+        std::ostringstream text;
+        return binlog::decode(binary, text);
+    }, {.batches = 3, .minBatchTime = std::chrono::milliseconds(100)});
+
+    std::filesystem::remove(directory / "binary_log_bench.txt");
+    std::filesystem::remove(directory / "binary_log_bench.binlog");
+    return 0;
+}
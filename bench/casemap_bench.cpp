@@ -0,0 +1,36 @@
+/**
+ * casemap_bench
+ *
+ * Table-driven casemap (toUpperCase(str)) vs std::locale toupper per code point (toUpperCase(str, loc)).
+ */
+
+#include <locale>
+#include <string>
+
+#include "../basics/strings.hpp"
+#include "bench.hpp"
+
+
+// g++ -std=c++23 -O2 casemap_bench.cpp -o /tmp/casemap_bench && /tmp/casemap_bench
+int main() {
+    const std::locale loc("en_US.UTF-8");
+    constexpr std::size_t size = 64 * 1024;
+
+    const std::pair<const char *, std::string> corpora[] = {
+        {"ascii", bench::repeat("The quick brown fox jumps over the lazy dog. ", size)},
+        {"latin", bench::repeat("Größenwahn naïve café Straße façade Ærøskøbing ", size)},
+        {"greek", bench::repeat("Ταχίστη αλώπηξ βαφής ψημένη γη, δρασκελίζει υπέρ νωθρού κυνός ", size)},
+        {"cyrillic", bench::repeat("Съешь же ещё этих мягких французских булок, да выпей чаю ", size)},
+        {"cjk+emoji", bench::repeat("早安 🐳 hello 世界 ¶ Hi ", size)},
+    };
+
+    for (const auto &[name, text] : corpora) {
+        bench::header(name);
+        bench::run("toUpperCase(str, std::locale)", text.size(), [&] { return toUpperCase(text, loc); });
+        bench::run("toUpperCase(str) casemap", text.size(), [&] { return toUpperCase(text); });
+        bench::run("toLowerCase(str) casemap", text.size(), [&] { return toLowerCase(text); });
+        bench::run("foldCase(str) casemap", text.size(), [&] { return foldCase(text); });
+    }
+
+    return 0;
+}
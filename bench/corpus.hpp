@@ -0,0 +1,171 @@
+/**
+ * corpus
+ *
+ * Deterministic multilingual UTF-8 text for the benchmarks: the same script, size and seed give the same bytes
+ * on every platform and standard library (own PRNG, no std::uniform_*_distribution).
+ *
+ * Words of 1 to 12 random letters (1 to 4 ideographs or emoji) separated by spaces, lines of about 80 bytes,
+ * some punctuation and numbers:
+ *  - ascii: lowercase words, some capitalized
+ *  - latin1: Latin words with about a third of letters from U+00C0..U+00FF (2 bytes)
+ *  - cyrillic: U+0410..U+044F and ё (2 bytes)
+ *  - cjk: CJK Unified Ideographs U+4E00..U+9FFF (3 bytes)
+ *  - emoji: U+1F300..U+1F64F (4 bytes)
+ *  - mixed: each word from one of the above, 40% ASCII, like `hello` in strings.cpp: "¶ Hi 早安 🐳"
+ * The text is well-formed and cut at a code point boundary: at most `bytes` long, at least `bytes` - 3.
+ *
+ * Usage:
+ *  const std::string text = corpus::generate(corpus::Script::mixed, {.bytes = 1 << 20});
+ *  for (const corpus::Script script : corpus::scripts) ...
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../basics/utf8.hpp"
+
+
+namespace corpus {
+
+    enum class Script : std::uint8_t {
+        ascii,
+        latin1,
+        cyrillic,
+        cjk,
+        emoji,
+        mixed,
+    };
+
+    inline constexpr std::array scripts{
+        Script::ascii, Script::latin1, Script::cyrillic, Script::cjk, Script::emoji, Script::mixed,
+    };
+
+    [[nodiscard]] constexpr auto name(const Script script) noexcept -> std::string_view {
+        constexpr std::array<std::string_view, 6> names{"ascii", "latin1", "cyrillic", "cjk", "emoji", "mixed"};
+        return names[static_cast<std::size_t>(script)];
+    }
+
+    [[nodiscard]] constexpr auto parse(const std::string_view text) noexcept -> std::optional<Script> {
+        for (const Script script : scripts) {
+            if (name(script) == text) return script;
+        }
+        return std::nullopt;
+    }
+
+    struct Options {
+        std::size_t bytes = 1 << 20;
+        std::uint64_t seed = 42;
+        std::size_t lineLength = 80; // bytes, a line ends after the first word that reaches it
+    };
+
+
+    namespace detail {
+
+        // SplitMix64: tiny, fast, and the same sequence everywhere
+        class Random {
+        public:
+            explicit Random(const std::uint64_t seed) noexcept : state_(seed) {}
+
+            auto next() noexcept -> std::uint64_t {
+                std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            }
+
+            // [0, bound), the modulo bias is irrelevant here
+            auto below(const std::uint64_t bound) noexcept -> std::uint64_t { return next() % bound; }
+
+        private:
+            std::uint64_t state_;
+        };
+
+        [[nodiscard]] inline auto letter(const Script script, Random &random) -> char32_t {
+            switch (script) {
+                case Script::latin1:
+                    if (random.below(3) == 0) {
+                        const auto cp = static_cast<char32_t>(0xC0 + random.below(0x40));
+                        return cp == 0xD7 || cp == 0xF7 ? U'é' : cp; // not × or ÷
+                    }
+                    return static_cast<char32_t>('a' + random.below(26));
+                case Script::cyrillic:
+                    return random.below(33) == 0 ? U'ё' : static_cast<char32_t>(0x0410 + random.below(0x40));
+                case Script::cjk:
+                    return static_cast<char32_t>(0x4E00 + random.below(0x9FFF - 0x4E00 + 1));
+                case Script::emoji:
+                    return static_cast<char32_t>(0x1F300 + random.below(0x1F64F - 0x1F300 + 1));
+                default:
+                    return static_cast<char32_t>('a' + random.below(26));
+            }
+        }
+
+        [[nodiscard]] inline auto pick(const Script script, Random &random) -> Script {
+            if (script != Script::mixed) return script;
+            // ASCII 40%, Latin-1 20%, Cyrillic 15%, CJK 15%, emoji 10%
+            const std::uint64_t roll = random.below(100);
+            if (roll < 40) return Script::ascii;
+            if (roll < 60) return Script::latin1;
+            if (roll < 75) return Script::cyrillic;
+            if (roll < 90) return Script::cjk;
+            return Script::emoji;
+        }
+
+    }
+
+
+    /**
+     * Generate a corpus.
+     *
+     * @param script alphabet of the words, or mixed
+     * @param options size in bytes, seed, line length
+     * @return well-formed UTF-8 text
+     */
+    [[nodiscard]] inline auto generate(const Script script, const Options &options = {}) -> std::string {
+        detail::Random random(options.seed ^ (static_cast<std::uint64_t>(script) << 56));
+        std::string text;
+        text.reserve(options.bytes + 64);
+        std::size_t lineStart = 0;
+
+        while (text.size() < options.bytes) {
+            const Script wordScript = detail::pick(script, random);
+            const std::uint64_t length = 1 + random.below(wordScript == Script::cjk || wordScript == Script::emoji ? 4 : 12);
+            for (std::uint64_t i = 0; i < length; ++i) {
+                char32_t cp = detail::letter(wordScript, random);
+                // Capitalize some ASCII / Latin words
+                if (i == 0 && cp < 0x80 && random.below(8) == 0) cp -= 'a' - 'A';
+                utf8::append(text, cp);
+            }
+
+            const std::uint64_t roll = random.below(40);
+            if (roll == 0) {
+                text += ',';
+            } else if (roll == 1) {
+                text += '.';
+            } else if (roll == 2) {
+                text += ' ';
+                text += std::to_string(random.below(10000));
+            }
+
+            if (text.size() - lineStart >= options.lineLength) {
+                text += '\n';
+                lineStart = text.size();
+            } else {
+                text += ' ';
+            }
+        }
+
+        // Cut at a code point boundary
+        std::size_t size = std::min(options.bytes, text.size());
+        while (size > 0 && size < text.size() && (static_cast<unsigned char>(text[size]) & 0xC0) == 0x80) --size;
+        text.resize(size);
+        return text;
+    }
+
+}
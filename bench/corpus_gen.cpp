@@ -0,0 +1,56 @@
+/**
+ * corpus_gen
+ *
+ * Write a deterministic UTF-8 corpus (corpus.hpp) to stdout, to feed the file and stdout benchmarks or
+ * external tools with the same input across runs and machines.
+ *
+ *  corpus_gen mixed 16M > /tmp/mixed.txt
+ *  corpus_gen cjk 100K 7 | wc -m
+ */
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "corpus.hpp"
+
+
+// 123, 64K, 16M, 1G
+[[nodiscard]] auto parseSize(const std::string_view text) -> std::optional<std::size_t> {
+    std::size_t value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || end == text.data()) return std::nullopt;
+    const std::string_view suffix(end, text.data() + text.size());
+    if (suffix.empty()) return value;
+    if (suffix == "K" || suffix == "k") return value << 10;
+    if (suffix == "M" || suffix == "m") return value << 20;
+    if (suffix == "G" || suffix == "g") return value << 30;
+    return std::nullopt;
+}
+
+// g++ -std=c++23 -O2 corpus_gen.cpp -o /tmp/corpus_gen && /tmp/corpus_gen mixed 1M > /tmp/mixed.txt
+int main(const int argc, char *argv[]) {
+    const auto usage = [argv] {
+        std::cerr << std::format("usage: {} ascii|latin1|cyrillic|cjk|emoji|mixed [size, 1M] [seed, 42]\n", argv[0]);
+        return 2;
+    };
+    if (argc < 2 || argc > 4) return usage();
+
+    const std::optional<corpus::Script> script = corpus::parse(argv[1]);
+    const std::optional<std::size_t> bytes = argc > 2 ? parseSize(argv[2]) : std::size_t{1} << 20;
+    const std::optional<std::size_t> seed = argc > 3 ? parseSize(argv[3]) : std::size_t{42};
+    if (!script || !bytes || !seed) return usage();
+
+    const std::string text = corpus::generate(*script, {.bytes = *bytes, .seed = *seed});
+    if (std::fwrite(text.data(), 1, text.size(), stdout) != text.size() || std::fflush(stdout) != 0) {
+        std::perror("corpus_gen");
+        return 1;
+    }
+    return 0;
+}
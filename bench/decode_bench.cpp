@@ -0,0 +1,46 @@
+/**
+ * decode_bench
+ *
+ * UTF-8 → UTF-32: split + decodeCodePoint per code point vs lazy code point view vs bulk decodeUTF8.
+ */
+
+#include <ranges>
+#include <string>
+
+#include "../basics/strings.hpp"
+#include "bench.hpp"
+
+
+// g++ -std=c++23 -O2 decode_bench.cpp -o /tmp/decode_bench && /tmp/decode_bench
+int main() {
+    constexpr std::size_t size = 1024 * 1024;
+
+    const std::pair<const char *, std::string> corpora[] = {
+        {"ascii", bench::repeat("The quick brown fox jumps over the lazy dog. ", size)},
+        {"mostly ascii (log lines)", bench::repeat("2025-07-13T10:00:00Z INFO user=jürgen action=login ok\n", size)},
+        {"cyrillic", bench::repeat("Съешь же ещё этих мягких французских булок, да выпей чаю ", size)},
+        {"cjk+emoji", bench::repeat("早安 🐳 hello 世界 ¶ Hi ", size)},
+    };
+
+    for (const auto &[name, text] : corpora) {
+        bench::header(name);
+        bench::run("splitIntoCodePoints + decodeCodePoint", text.size(), [&] {
+            std::u32string result;
+            for (const std::string_view &codePoint : splitIntoCodePoints(text)) {
+                result += decodeCodePoint(codePoint);
+            }
+            return result;
+        });
+        bench::run("utf8::codePoints view | ranges::to", text.size(), [&] {
+            return utf8::codePoints(text) | std::ranges::to<std::u32string>();
+        });
+        bench::run("decodeUTF8(str) bulk", text.size(), [&] { return decodeUTF8(text); });
+
+        std::u32string buffer(text.size(), U'\0');
+        bench::run("decodeUTF8(str, span) into buffer", text.size(), [&] {
+            return decodeUTF8(text, buffer).written;
+        });
+    }
+
+    return 0;
+}
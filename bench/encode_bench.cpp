@@ -0,0 +1,52 @@
+/**
+ * encode_bench
+ *
+ * UTF-32 → UTF-8: string per code point vs append into a reserved string vs bulk encode.
+ */
+
+#include <iterator>
+#include <ranges>
+#include <string>
+
+#include "../basics/strings.hpp"
+#include "bench.hpp"
+
+
+// g++ -std=c++23 -O2 encode_bench.cpp -o /tmp/encode_bench && /tmp/encode_bench
+int main() {
+    constexpr std::size_t size = 256 * 1024;
+
+    const std::pair<const char *, std::string> corpora[] = {
+        {"ascii", bench::repeat("The quick brown fox jumps over the lazy dog. ", size)},
+        {"cyrillic", bench::repeat("Съешь же ещё этих мягких французских булок, да выпей чаю ", size)},
+        {"cjk+emoji", bench::repeat("早安 🐳 hello 世界 ¶ Hi ", size)},
+    };
+
+    for (const auto &[name, text] : corpora) {
+        const auto wide = utf8::codePoints(text) | std::ranges::to<std::u32string>();
+        const std::size_t bytes = text.size();
+
+        bench::header(name);
+        bench::run("result += encodeUTF8(cp)", bytes, [&] {
+            std::string result;
+            for (const char32_t cp : wide) result += encodeUTF8(cp);
+            return result;
+        });
+        bench::run("encodeUTF8(cp, back_inserter), reserved", bytes, [&] {
+            std::string result;
+            result.reserve(wide.size() * 4);
+            auto out = std::back_inserter(result);
+            for (const char32_t cp : wide) out = encodeUTF8(cp, out);
+            return result;
+        });
+        bench::run("utf8::append(result, cp), reserved", bytes, [&] {
+            std::string result;
+            result.reserve(wide.size() * 4);
+            for (const char32_t cp : wide) utf8::append(result, cp);
+            return result;
+        });
+        bench::run("encodeUTF8(span<const char32_t>) bulk", bytes, [&] { return encodeUTF8(wide); });
+    }
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * file_read_bench
+ *
+ * Loading a file: istreambuf_iterator (file_read/rdbuf.cpp) vs ifstream::read into a sized string vs MappedFile,
+ * then the same plus splitting into lines.
+ * The file is in the page cache after the first run, so this measures copies and per-char overhead, not the disk.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "../basics/strings.hpp"
+#include "../file_read/mapped_file.hpp"
+#include "bench.hpp"
+
+
+// Count newlines, so mapped pages are actually touched
+[[nodiscard]] auto countLines(const std::string_view &text) -> std::size_t {
+    std::size_t lines = 0;
+    for (const char c : text) lines += c == '\n';
+    return lines;
+}
+
+// g++ -std=c++23 -O2 file_read_bench.cpp -o /tmp/file_read_bench && /tmp/file_read_bench
+int main() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "file_read_bench.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (std::size_t i = 0; i < 1024 * 1024; ++i) {
+            out << std::format("{},Съешь же ещё этих мягких булок,{},早安 🐳\n", i, i * 7);
+        }
+    }
+    const std::size_t size = std::filesystem::file_size(path);
+    const bench::Options options{.batches = 5, .minBatchTime = std::chrono::milliseconds(100)};
+
+    bench::header(std::format("load {} MB", size >> 20));
+    bench::run("istreambuf_iterator (rdbuf.cpp)", size, [&] {
+        std::ifstream in(path, std::ios::binary);
+        const std::string content(std::istreambuf_iterator<char>(in.rdbuf()), {});
+        return countLines(content);
+    }, options);
+    bench::run("ifstream::read into sized string", size, [&] {
+        std::ifstream in(path, std::ios::binary);
+        std::string content(std::filesystem::file_size(path), '\0');
+        in.read(content.data(), static_cast<std::streamsize>(content.size()));
+        return countLines(content);
+    }, options);
+    bench::run("MappedFile", size, [&] {
+        const MappedFile file(path);
+        return countLines(file);
+    }, options);
+
+    bench::header("load + splitString(file, '\\n')");
+    bench::run("istreambuf_iterator (rdbuf.cpp)", size, [&] {
+        std::ifstream in(path, std::ios::binary);
+        const std::string content(std::istreambuf_iterator<char>(in.rdbuf()), {});
+        return splitString(content, '\n').size();
+    }, options);
+    bench::run("MappedFile", size, [&] {
+        const MappedFile file(path);
+        return splitString(file, '\n').size();
+    }, options);
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * file_write_bench
+ *
+ * Writing many short lines: ofstream + std::endl (file_write/fstream.cpp) vs ofstream + '\n' vs fwrite
+ * vs BatchWriter. Without fdatasync this measures the path to the page cache, not the disk.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../file_write/batch_writer.hpp"
+#include "bench.hpp"
+
+
+// g++ -std=c++23 -O2 file_write_bench.cpp -o /tmp/file_write_bench && /tmp/file_write_bench
+int main() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "file_write_bench.txt";
+
+    std::vector<std::string> lines;
+    std::size_t size = 0;
+    for (std::size_t i = 0; size < 64 * 1024 * 1024; ++i) {
+        lines.push_back(std::format("{},Съешь же ещё этих мягких булок,{},早安 🐳", i, i * 7));
+        size += lines.back().size() + 1;
+    }
+    const bench::Options options{.batches = 3, .minBatchTime = std::chrono::milliseconds(100)};
+
+    bench::header(std::format("{} MB in {} lines", size >> 20, lines.size()));
+    bench::run("ofstream << line << std::endl", size, [&] {
+        std::ofstream out(path, std::ios::binary);
+        for (const std::string &line : lines) out << line << std::endl;
+        return out.good();
+    }, options);
+    bench::run("ofstream << line << '\\n'", size, [&] {
+        std::ofstream out(path, std::ios::binary);
+        for (const std::string &line : lines) out << line << '\n';
+        return out.good();
+    }, options);
+    bench::run("fwrite + fputc", size, [&] {
+        std::FILE *out = std::fopen(path.c_str(), "wb");
+        for (const std::string &line : lines) {
+            std::fwrite(line.data(), 1, line.size(), out);
+            std::fputc('\n', out);
+        }
+        return std::fclose(out) == 0;
+    }, options);
+    bench::run("BatchWriter::writeLine", size, [&] {
+        BatchWriter out(path);
+        for (const std::string &line : lines) out.writeLine(line);
+        out.close();
+        return out.bytesWritten();
+    }, options);
+    bench::run("BatchWriter::writeLine, preallocated", size, [&] {
+        BatchWriter out(path, {.preallocate = size});
+        for (const std::string &line : lines) out.writeLine(line);
+        out.close();
+        return out.bytesWritten();
+    }, options);
+    bench::run("BatchWriter::writeLine, 4 MB buffer", size, [&] {
+        BatchWriter out(path, {.bufferSize = 4 << 20});
+        for (const std::string &line : lines) out.writeLine(line);
+        out.close();
+        return out.bytesWritten();
+    }, options);
+
+    bench::header("durability");
+    bench::run("BatchWriter, fdatasync on close", size, [&] {
+        BatchWriter out(path, {.durability = BatchWriter::Durability::onClose});
+        for (const std::string &line : lines) out.writeLine(line);
+        out.close();
+        return out.bytesWritten();
+    }, options);
+    bench::run("BatchWriter, fdatasync every 16 MB", size, [&] {
+        BatchWriter out(path, {.durability = BatchWriter::Durability::periodic, .syncEvery = 16 << 20});
+        for (const std::string &line : lines) out.writeLine(line);
+        out.close();
+        return out.bytesWritten();
+    }, options);
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * flat_hash_bench
+ *
+ * std::unordered_set<IntOrString> (std::hash as in concepts.cpp) vs flat::IntOrStringSet:
+ * insert, lookup of keys parsed from a text buffer (hits and misses), iteration. Half of the keys are ints,
+ * half strings of 8-40 chars. Plus the string hash alone.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "../concepts/flat_hash.hpp"
+#include "bench.hpp"
+
+
+using IntOrString = std::variant<int, std::string>;
+
+template<>
+struct std::hash<IntOrString> {
+    std::size_t operator()(const IntOrString &value) const noexcept {
+        return value.index() == 0
+            ? std::hash<int>{}(std::get<int>(value))
+            : std::hash<std::string>{}(std::get<std::string>(value));
+    }
+};
+
+// A parsed record field: either digits or a name, as a view into the input buffer
+struct Field {
+    std::string_view text;
+    bool isNumber;
+    int number;
+};
+
+// g++ -std=c++23 -O2 flat_hash_bench.cpp -o /tmp/flat_hash_bench && /tmp/flat_hash_bench
+int main() {
+    constexpr std::size_t count = 1 << 20;
+    std::mt19937_64 random(42);
+
+    std::vector<IntOrString> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 2 == 0) {
+            keys.emplace_back(static_cast<int>(random()));
+        } else {
+            std::string name = std::format("user-{:x}", random());
+            name.resize(8 + random() % 33, '_');
+            keys.emplace_back(std::move(name));
+        }
+    }
+
+    // Lookup input: the keys as text in one buffer (every other one missing), like fields of a parsed file
+    std::string buffer;
+    std::vector<std::pair<std::size_t, std::size_t>> spans;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::size_t start = buffer.size();
+        if (const int *number = std::get_if<int>(&keys[i])) {
+            buffer += std::to_string(i % 4 == 0 ? *number : *number ^ 1);
+        } else {
+            buffer += std::get<std::string>(keys[i]);
+            if (i % 4 == 1) buffer.back() = '!';
+        }
+        spans.emplace_back(start, buffer.size() - start);
+    }
+    std::vector<Field> fields;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string_view text(buffer.data() + spans[i].first, spans[i].second);
+        const bool isNumber = std::holds_alternative<int>(keys[i]);
+        fields.push_back({text, isNumber, isNumber ? std::stoi(std::string(text)) : 0});
+    }
+
+    const bench::Options options{.batches = 5, .minBatchTime = std::chrono::milliseconds(200)};
+    bench::header(std::format("{} keys, half ints, half strings, ns per pass over all keys", count));
+
+    bench::run("insert, std::unordered_set", 0, [&] {
+        std::unordered_set<IntOrString> set;
+        for (const IntOrString &key : keys) set.insert(key);
+        return set.size();
+    }, options);
+    bench::run("insert, flat::IntOrStringSet", 0, [&] {
+        flat::IntOrStringSet set;
+        for (const IntOrString &key : keys) set.insert(key);
+        return set.size();
+    }, options);
+
+    std::unordered_set<IntOrString> stdSet(keys.begin(), keys.end());
+    flat::IntOrStringSet flatSet;
+    for (const IntOrString &key : keys) flatSet.insert(key);
+
+    // The node-based set needs a whole IntOrString per lookup: a std::string for names, allocated above 15 chars
+    bench::run("parsed lookup, std::unordered_set", 0, [&] {
+        std::size_t found = 0;
+        for (const Field &field : fields) {
+            found += field.isNumber ? stdSet.contains(field.number) : stdSet.contains(IntOrString(std::string(field.text)));
+        }
+        return found;
+    }, options);
+    bench::run("parsed lookup, flat::IntOrStringSet", 0, [&] {
+        std::size_t found = 0;
+        for (const Field &field : fields) {
+            found += field.isNumber ? flatSet.contains(field.number) : flatSet.contains(field.text);
+        }
+        return found;
+    }, options);
+
+    bench::run("iterate, std::unordered_set", 0, [&] {
+        std::size_t ints = 0;
+        for (const IntOrString &key : stdSet) ints += key.index() == 0;
+        return ints;
+    }, options);
+    bench::run("iterate, flat::IntOrStringSet", 0, [&] {
+        std::size_t ints = 0;
+        for (const IntOrString &key : flatSet) ints += key.index() == 0;
+        return ints;
+    }, options);
+
+    bench::header("hash all the keys as strings");
+    bench::run("std::hash<std::string_view>", 0, [&] {
+        std::size_t sum = 0;
+        for (const Field &field : fields) sum += std::hash<std::string_view>{}(field.text);
+        return sum;
+    }, options);
+    bench::run("flat::IntOrStringHash", 0, [&] {
+        std::uint64_t sum = 0;
+        for (const Field &field : fields) sum += flat::IntOrStringHash{}(field.text);
+        return sum;
+    }, options);
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * flat_set_bench
+ *
+ * std::set<IntOrString, IntOrStringComparator> (as in concepts.cpp) vs flat::SortedIntOrStringSet:
+ * building from 1M unsorted keys with duplicates, sequentially and with std::execution::par, then lookups.
+ * Int lookups are also compared with a plain binary search over the sorted ints, to see the Eytzinger layout.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <format>
+#include <random>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../concepts/flat_set.hpp"
+#include "../concepts/int_or_string.hpp"
+#include "bench.hpp"
+
+
+// g++ -std=c++23 -O2 flat_set_bench.cpp -o /tmp/flat_set_bench -ltbb && /tmp/flat_set_bench
+int main() {
+    constexpr std::size_t count = 1 << 20;
+    std::mt19937_64 random(42);
+
+    // About a quarter duplicates
+    const auto makeKey = [&random]() -> IntOrString {
+        const std::uint64_t value = random() % (3 * count);
+        if (value % 2 == 0) return static_cast<int>(value * 2654435761u);
+        return std::format("item-{:08x}-{}", value, value % 97);
+    };
+    std::vector<IntOrString> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) keys.push_back(makeKey());
+
+    std::vector<IntOrString> queries;
+    for (std::size_t i = 0; i < count / 4; ++i) queries.push_back(i % 2 ? keys[random() % count] : makeKey());
+    std::vector<int> intQueries;
+    for (const IntOrString &query : queries) {
+        if (const int *number = std::get_if<int>(&query)) intQueries.push_back(*number);
+    }
+
+    const bench::Options options{.batches = 3, .minBatchTime = std::chrono::milliseconds(200)};
+    bench::header(std::format("build from {}M unsorted keys", count >> 20));
+    bench::run("std::set, insert one by one", 0, [&] {
+        return std::set<IntOrString, IntOrStringComparator>(keys.begin(), keys.end()).size();
+    }, options);
+    bench::run("fromUnsorted", 0, [&] {
+        return flat::SortedIntOrStringSet::fromUnsorted(keys).size();
+    }, options);
+    bench::run("fromUnsorted, std::execution::par", 0, [&] {
+        return flat::SortedIntOrStringSet::fromUnsorted(std::execution::par, keys).size();
+    }, options);
+
+    const std::set<IntOrString, IntOrStringComparator> tree(keys.begin(), keys.end());
+    const auto flatSet = flat::SortedIntOrStringSet::fromUnsorted(std::execution::par, keys);
+
+    bench::header(std::format("{}K lookups, half hits", queries.size() >> 10));
+    bench::run("std::set", 0, [&] {
+        std::size_t found = 0;
+        for (const IntOrString &query : queries) found += tree.contains(query);
+        return found;
+    }, options);
+    bench::run("SortedIntOrStringSet", 0, [&] {
+        std::size_t found = 0;
+        for (const IntOrString &query : queries) found += flatSet.contains(query);
+        return found;
+    }, options);
+
+    bench::header(std::format("{}K int lookups", intQueries.size() >> 10));
+    bench::run("std::ranges::binary_search, sorted ints", 0, [&] {
+        std::size_t found = 0;
+        for (const int query : intQueries) found += std::ranges::binary_search(flatSet.ints(), query);
+        return found;
+    }, options);
+    bench::run("SortedIntOrStringSet, Eytzinger", 0, [&] {
+        std::size_t found = 0;
+        for (const int query : intQueries) found += flatSet.contains(query);
+        return found;
+    }, options);
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * format_bench
+ *
+ * One console::log line built with operator<< (as before) vs std::format_to into a reused std::string
+ * (as console::log does now): a set of 16 IntOrString, an Ink, ints and a double. Both render the same text:
+ * the IntOrString keys are formatted alternative by alternative (no std::formatter for a std::variant, which
+ * is not a program-defined type), the double with {:.6g}, the operator<< default.
+ * Then the whole call, written to /dev/null: std::cout << ... << std::endl vs one buffer and one write.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
+#include <variant>
+
+#include "bench.hpp"
+
+
+using IntOrString = std::variant<int, std::string>;
+
+std::ostream &operator<<(std::ostream &out, const IntOrString &value) {
+    if (const int *number = std::get_if<int>(&value)) return out << "i_" << *number;
+    return out << "s_" << std::get<std::string>(value);
+}
+
+struct Ink {
+    std::string color;
+};
+
+std::ostream &operator<<(std::ostream &out, const Ink &ink) {
+    return out << "Ink { color: " << ink.color << " }";
+}
+
+template<>
+struct std::formatter<Ink> {
+    constexpr auto parse(std::format_parse_context &context) { return context.begin(); }
+
+    auto format(const Ink &ink, std::format_context &context) const {
+        return std::format_to(context.out(), "Ink {{ color: {} }}", ink.color);
+    }
+};
+
+using Keys = std::set<IntOrString>;
+
+std::ostream &operator<<(std::ostream &out, const Keys &keys) {
+    bool isFirst = true;
+    for (const IntOrString &key : keys) {
+        if (!isFirst) out << ", ";
+        out << key;
+        isFirst = false;
+    }
+    return out;
+}
+
+void appendKeys(std::string &buffer, const Keys &keys) {
+    bool isFirst = true;
+    for (const IntOrString &key : keys) {
+        if (!isFirst) buffer += ", ";
+        if (const int *number = std::get_if<int>(&key)) {
+            std::format_to(std::back_inserter(buffer), "i_{}", *number);
+        } else {
+            buffer += "s_";
+            buffer += std::get<std::string>(key);
+        }
+        isFirst = false;
+    }
+}
+
+// g++ -std=c++23 -O2 format_bench.cpp -o /tmp/format_bench && /tmp/format_bench
+int main() {
+    Keys keys;
+    for (int i = 0; i < 8; ++i) {
+        keys.insert(i * 1'234'567);
+        keys.insert(std::format("key-{}", i));
+    }
+    const Ink ink{"warhammer-khorne-red"};
+    int event = 0;
+
+    std::string line;
+    bench::header("build one line");
+    bench::run("operator<<, std::ostringstream", 0, [&] {
+        std::ostringstream out;
+        const int id = ++event;
+        out << "event " << id << ": " << keys << " with " << ink << ", ratio " << 1.0 / id << '\n';
+        return out.str().size();
+    });
+    bench::run("operator<<, reused std::ostringstream", 0, [&] {
+        thread_local std::ostringstream out;
+        out.str({});
+        const int id = ++event;
+        out << "event " << id << ": " << keys << " with " << ink << ", ratio " << 1.0 / id << '\n';
+        return out.view().size();
+    });
+    bench::run("std::format_to, reused std::string", 0, [&] {
+        line.clear();
+        const int id = ++event;
+        std::format_to(std::back_inserter(line), "event {}: ", id);
+        appendKeys(line, keys);
+        std::format_to(std::back_inserter(line), " with {}, ratio {:.6g}\n", ink, 1.0 / id);
+        return line.size();
+    });
+
+    // Both paths write to std::cout, redirected to /dev/null
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) return 1;
+    bench::Result results[2];
+    results[0] = bench::run("std::cout << ... << std::endl", 0, [&] {
+        const int id = ++event;
+        std::cout << "event " << id << ": " << keys << " with " << ink << ", ratio " << 1.0 / id << std::endl;
+    });
+    results[1] = bench::run("std::format_to, one std::cout.write", 0, [&] {
+        line.clear();
+        const int id = ++event;
+        std::format_to(std::back_inserter(line), "event {}: ", id);
+        appendKeys(line, keys);
+        std::format_to(std::back_inserter(line), " with {}, ratio {:.6g}\n", ink, 1.0 / id);
+        std::cout.write(line.data(), static_cast<std::streamsize>(line.size())).flush();
+    });
+    std::cerr << "\n## log one line to /dev/null\n";
+    for (const bench::Result &result : results) std::cerr << std::format("{:<48} {:>14.1f}\n", result.name, result.nsPerOp);
+
+    return 0;
+}
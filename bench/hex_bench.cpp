@@ -0,0 +1,78 @@
+/**
+ * hex_bench
+ *
+ * Hex encoding of 32-byte digests and of a 1 MB payload: the views pipeline of cpp23/range_formatter.cpp
+ * (std::format per byte, std::vector<std::string>, views::join), std::format_to per byte into one string,
+ * and hex::encode (cpp23/hex.hpp). Then decoding: std::from_chars per pair vs hex::decode.
+ *
+ * The kernel is picked at runtime, run with SIMD_LEVEL=sse2 or SIMD_LEVEL=scalar to compare the fallbacks.
+ */
+
+#include <charconv>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "../basics/simd.hpp"
+#include "../cpp23/hex.hpp"
+#include "bench.hpp"
+
+
+// As in range_formatter.cpp
+[[nodiscard]] auto viewsPipeline(const std::vector<unsigned char> &bytes) -> std::string {
+    auto digits = bytes | std::views::transform([](const unsigned char byte) { return std::format("{:02x}", byte); })
+                        | std::ranges::to<std::vector<std::string>>();
+    return digits | std::views::join | std::ranges::to<std::string>();
+}
+
+[[nodiscard]] auto formatTo(const std::vector<unsigned char> &bytes) -> std::string {
+    std::string result;
+    result.reserve(2 * bytes.size());
+    for (const unsigned char byte : bytes) std::format_to(std::back_inserter(result), "{:02x}", byte);
+    return result;
+}
+
+[[nodiscard]] auto fromChars(const std::string_view digits) -> std::vector<unsigned char> {
+    std::vector<unsigned char> bytes(digits.size() / 2);
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        if (std::from_chars(digits.data() + 2 * i, digits.data() + 2 * i + 2, bytes[i], 16).ec != std::errc{}) return {};
+    }
+    return bytes;
+}
+
+void compare(const std::string_view title, const std::vector<unsigned char> &bytes) {
+    const std::string digits = hex::encode(bytes);
+    const bench::Options options{.batches = 5, .minBatchTime = std::chrono::milliseconds(50)};
+
+    bench::header(std::format("{}, encode, MB/s of input", title));
+    bench::run("views::transform + views::join", bytes.size(), [&] { return viewsPipeline(bytes); }, options);
+    bench::run("std::format_to per byte", bytes.size(), [&] { return formatTo(bytes); }, options);
+    bench::run("hex::encode", bytes.size(), [&] { return hex::encode(bytes); }, options);
+    bench::run("std::format(\"{}\", hex::view(bytes))", bytes.size(), [&] {
+        return std::format("{}", hex::view(bytes));
+    }, options);
+
+    bench::header(std::format("{}, decode, MB/s of input", title));
+    bench::run("std::from_chars per pair", digits.size(), [&] { return fromChars(digits); }, options);
+    bench::run("hex::decode", digits.size(), [&] { return hex::decode(digits); }, options);
+}
+
+// g++ -std=c++23 -O2 hex_bench.cpp -o /tmp/hex_bench && /tmp/hex_bench
+int main() {
+    std::mt19937 random(42);
+    const auto randomBytes = [&random](const std::size_t size) {
+        std::vector<unsigned char> bytes(size);
+        for (unsigned char &byte : bytes) byte = static_cast<unsigned char>(random());
+        return bytes;
+    };
+
+    std::cout << "SIMD level: " << simd::name(simd::level()) << '\n';
+    compare("32-byte digest", randomBytes(32));
+    compare("1 MB payload", randomBytes(1 << 20));
+    return 0;
+}
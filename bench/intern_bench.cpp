@@ -0,0 +1,150 @@
+/**
+ * intern_bench
+ *
+ * Ink holding a std::string (as before) vs Ink holding an intern::Symbol, 1M objects named from a vocabulary
+ * of 64 colors (half of them longer than the 15-char small string buffer): construction from parsed names,
+ * std::unordered_set lookups, equality. Then interning from 1-8 threads at once, lock-free lookups vs
+ * a std::unordered_map behind a std::mutex.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../concepts/intern.hpp"
+#include "bench.hpp"
+
+
+struct StringInk {
+    std::string color;
+    bool operator==(const StringInk &other) const { return color == other.color; }
+};
+
+struct SymbolInk {
+    intern::Symbol color;
+    bool operator==(const SymbolInk &other) const { return color == other.color; }
+};
+
+template<>
+struct std::hash<StringInk> {
+    std::size_t operator()(const StringInk &ink) const noexcept { return std::hash<std::string>{}(ink.color); }
+};
+
+template<>
+struct std::hash<SymbolInk> {
+    std::size_t operator()(const SymbolInk &ink) const noexcept { return std::hash<intern::Symbol>{}(ink.color); }
+};
+
+// The baseline for concurrent interning
+class LockedTable {
+public:
+    auto intern(const std::string_view text) -> std::uint32_t {
+        const std::scoped_lock lock(mutex_);
+        return ids_.try_emplace(std::string(text), static_cast<std::uint32_t>(ids_.size())).first->second;
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::uint32_t> ids_;
+};
+
+// Run `fn(thread)` on `threads` threads and wait
+template<typename Fn>
+void onThreads(const std::size_t threads, Fn &&fn) {
+    std::vector<std::jthread> workers;
+    for (std::size_t thread = 0; thread < threads; ++thread) workers.emplace_back([&fn, thread] { fn(thread); });
+}
+
+// g++ -std=c++23 -O2 -pthread intern_bench.cpp -o /tmp/intern_bench && /tmp/intern_bench
+int main() {
+    constexpr std::size_t count = 1 << 20;
+    std::mt19937_64 random(42);
+
+    std::vector<std::string> vocabulary;
+    for (std::size_t i = 0; i < 64; ++i) {
+        vocabulary.push_back(i % 2 ? std::format("color-{}", i) : std::format("warhammer-paint-color-{}", i));
+    }
+    std::vector<std::string_view> names;
+    for (std::size_t i = 0; i < count; ++i) names.emplace_back(vocabulary[random() % vocabulary.size()]);
+
+    std::cout << std::format("sizeof: StringInk {} bytes + heap for long names, SymbolInk {} bytes\n",
+                             sizeof(StringInk), sizeof(SymbolInk));
+
+    const bench::Options options{.batches = 5, .minBatchTime = std::chrono::milliseconds(100)};
+    bench::header(std::format("{}K objects, ns per pass", count >> 10));
+    bench::run("construct, StringInk", 0, [&] {
+        std::vector<StringInk> inks;
+        inks.reserve(count);
+        for (const std::string_view name : names) inks.push_back({std::string(name)});
+        return inks.size();
+    }, options);
+    bench::run("construct, SymbolInk (interning lookup)", 0, [&] {
+        std::vector<SymbolInk> inks;
+        inks.reserve(count);
+        for (const std::string_view name : names) inks.push_back({intern::Symbol(name)});
+        return inks.size();
+    }, options);
+
+    std::vector<StringInk> stringInks;
+    std::vector<SymbolInk> symbolInks;
+    for (const std::string_view name : names) {
+        stringInks.push_back({std::string(name)});
+        symbolInks.push_back({intern::Symbol(name)});
+    }
+    std::unordered_set<StringInk> stringSet(stringInks.begin(), stringInks.begin() + 1000);
+    std::unordered_set<SymbolInk> symbolSet(symbolInks.begin(), symbolInks.begin() + 1000);
+
+    bench::run("unordered_set lookup, StringInk", 0, [&] {
+        std::size_t found = 0;
+        for (const StringInk &ink : stringInks) found += stringSet.contains(ink);
+        return found;
+    }, options);
+    bench::run("unordered_set lookup, SymbolInk", 0, [&] {
+        std::size_t found = 0;
+        for (const SymbolInk &ink : symbolInks) found += symbolSet.contains(ink);
+        return found;
+    }, options);
+    bench::run("operator== with the next one, StringInk", 0, [&] {
+        std::size_t equal = 0;
+        for (std::size_t i = 1; i < count; ++i) equal += stringInks[i] == stringInks[i - 1];
+        return equal;
+    }, options);
+    bench::run("operator== with the next one, SymbolInk", 0, [&] {
+        std::size_t equal = 0;
+        for (std::size_t i = 1; i < count; ++i) equal += symbolInks[i] == symbolInks[i - 1];
+        return equal;
+    }, options);
+
+    // Every thread interns all the names: after the first pass, each call only looks up
+    constexpr std::size_t perThread = count / 4;
+    for (const std::size_t threads : {1, 2, 4, 8}) {
+        bench::header(std::format("{} threads, {}K interning calls each, ns per pass", threads, perThread >> 10));
+        intern::SymbolTable table;
+        LockedTable locked;
+        bench::run("intern::SymbolTable", 0, [&] {
+            onThreads(threads, [&](const std::size_t thread) {
+                std::uint32_t sum = 0;
+                for (std::size_t i = 0; i < perThread; ++i) sum += table.intern(names[(thread * perThread + i) % count]);
+                bench::doNotOptimize(sum);
+            });
+        }, options);
+        bench::run("std::unordered_map + std::mutex", 0, [&] {
+            onThreads(threads, [&](const std::size_t thread) {
+                std::uint32_t sum = 0;
+                for (std::size_t i = 0; i < perThread; ++i) sum += locked.intern(names[(thread * perThread + i) % count]);
+                bench::doNotOptimize(sum);
+            });
+        }, options);
+    }
+
+    return 0;
+}
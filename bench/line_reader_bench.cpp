@@ -0,0 +1,61 @@
+/**
+ * line_reader_bench
+ *
+ * Line-by-line processing: std::getline vs LineReader (synchronous / with prefetch) vs MappedFile + lazy split.
+ * Each line is validated as UTF-8, so there is some work for the prefetch thread to overlap with.
+ * The file is in the page cache after the first run; drop caches (echo 3 > /proc/sys/vm/drop_caches)
+ * between runs to measure the disk.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "../basics/strings.hpp"
+#include "../file_read/line_reader.hpp"
+#include "../file_read/mapped_file.hpp"
+#include "bench.hpp"
+
+
+// g++ -std=c++23 -O2 -pthread line_reader_bench.cpp -o /tmp/line_reader_bench && /tmp/line_reader_bench
+int main() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "line_reader_bench.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (std::size_t i = 0; i < 1024 * 1024; ++i) {
+            out << std::format("{},Съешь же ещё этих мягких булок,{},早安 🐳\n", i, i * 7);
+        }
+    }
+    const std::size_t size = std::filesystem::file_size(path);
+    const bench::Options options{.batches = 5, .minBatchTime = std::chrono::milliseconds(100)};
+
+    bench::header(std::format("{} MB, validate each line", size >> 20));
+    bench::run("std::getline", size, [&] {
+        std::ifstream in(path, std::ios::binary);
+        std::size_t valid = 0;
+        for (std::string line; std::getline(in, line);) valid += utf8::isValid(line);
+        return valid;
+    }, options);
+    bench::run("LineReader, no prefetch", size, [&] {
+        LineReader reader(path, {.prefetch = false});
+        std::size_t valid = 0;
+        for (const std::string_view line : reader) valid += utf8::isValid(line);
+        return valid;
+    }, options);
+    bench::run("LineReader, prefetch thread", size, [&] {
+        LineReader reader(path, {.prefetch = true});
+        std::size_t valid = 0;
+        for (const std::string_view line : reader) valid += utf8::isValid(line);
+        return valid;
+    }, options);
+    bench::run("MappedFile + Splitter::split", size, [&] {
+        const MappedFile file(path);
+        const split::Splitter newline('\n');
+        std::size_t valid = 0;
+        for (const std::string_view line : newline.split(file)) valid += utf8::isValid(line);
+        return valid;
+    }, options);
+
+    std::filesystem::remove(path);
+    return 0;
+}
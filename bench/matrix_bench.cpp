@@ -0,0 +1,105 @@
+/**
+ * matrix_bench
+ *
+ * n x n double matrix multiply in GFLOP/s (2n^3 operations): the naive i-j-k triple loop on row-major data
+ * against linalg::multiply (cpp23/matrix.hpp) with row-major, column-major and 64 x 64 tiled layouts, and
+ * the row-major kernel on all hardware threads. Then transpose in GB/s of input, naive vs blocked.
+ *
+ * The default sizes go from three matrices in L1 (32) to a few MB per matrix (1024, 2048), pass sizes as
+ * arguments to go beyond the last level cache: e.g. 4096 is 128 MB per matrix. The naive loops are skipped
+ * above 1024, they take minutes there. Tiled matrices are padded to whole tiles, a 32 x 32 one costs a 64 x 64
+ * multiply.
+ * Build with -march=native as well to get AVX instead of SSE2 in the vectorized kernels.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../cpp23/matrix.hpp"
+#include "bench.hpp"
+
+
+template<typename Layout>
+[[nodiscard]] auto randomMatrix(const std::size_t n, std::mt19937 &random) -> linalg::Matrix<double, Layout> {
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    linalg::Matrix<double, Layout> matrix(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) matrix[i, j] = distribution(random);
+    }
+    return matrix;
+}
+
+// Textbook loop: b is read down a column, one cache line per multiply-add once b is out of cache
+[[nodiscard]] auto naiveMultiply(const linalg::Matrix<double> &a, const linalg::Matrix<double> &b) -> linalg::Matrix<double> {
+    const std::size_t n = a.rows();
+    linalg::Matrix<double> c(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            double sum = 0;
+            for (std::size_t k = 0; k < n; ++k) sum += a[i, k] * b[k, j];
+            c[i, j] = sum;
+        }
+    }
+    return c;
+}
+
+[[nodiscard]] auto naiveTranspose(const linalg::Matrix<double> &a) -> linalg::Matrix<double> {
+    linalg::Matrix<double> t(a.cols(), a.rows());
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        for (std::size_t j = 0; j < a.cols(); ++j) t[j, i] = a[i, j];
+    }
+    return t;
+}
+
+void compare(const std::size_t n, const unsigned threads) {
+    std::mt19937 random(42);
+    const auto rowA = randomMatrix<std::layout_right>(n, random);
+    const auto rowB = randomMatrix<std::layout_right>(n, random);
+    const auto columnA = randomMatrix<std::layout_left>(n, random);
+    const auto columnB = randomMatrix<std::layout_left>(n, random);
+    const auto tileA = randomMatrix<linalg::TiledLayout<64>>(n, random);
+    const auto tileB = randomMatrix<linalg::TiledLayout<64>>(n, random);
+
+    const double flops = 2.0 * static_cast<double>(n) * static_cast<double>(n) * static_cast<double>(n);
+    const bench::Options options{.batches = 3, .minBatchTime = std::chrono::milliseconds(100)};
+    std::vector<std::pair<std::string, double>> rates;
+    const auto run = [&](const std::string &name, auto &&fn) {
+        rates.emplace_back(name, flops / bench::run(name, 0, fn, options).nsPerOp);
+    };
+
+    bench::header(std::format("multiply {0} x {0}, {1} KB per matrix", n, n * n * sizeof(double) / 1024));
+    if (n <= 1024) run("naive i-j-k", [&] { return naiveMultiply(rowA, rowB); });
+    run("linalg::multiply, row-major", [&] { return linalg::multiply(rowA, rowB); });
+    run("linalg::multiply, column-major", [&] { return linalg::multiply(columnA, columnB); });
+    run("linalg::multiply, tiled 64", [&] { return linalg::multiply(tileA, tileB); });
+    run(std::format("linalg::multiply, row-major, {} threads", threads), [&] {
+        return linalg::multiply(rowA, rowB, {.threads = threads});
+    });
+    for (const auto &[name, rate] : rates) std::cout << std::format("{:<48} {:>9.2f} GFLOP/s\n", name, rate);
+
+    bench::header(std::format("transpose {0} x {0}, MB/s of input", n));
+    const std::size_t bytes = n * n * sizeof(double);
+    if (n <= 1024) bench::run("naive", bytes, [&] { return naiveTranspose(rowA); }, options);
+    bench::run("linalg::transpose, row-major", bytes, [&] { return linalg::transpose(rowA); }, options);
+    bench::run("linalg::transpose, tiled 64", bytes, [&] { return linalg::transpose(tileA); }, options);
+}
+
+// g++ -std=c++23 -O2 matrix_bench.cpp -o /tmp/matrix_bench && /tmp/matrix_bench [sizes...]
+int main(const int argc, char *argv[]) {
+    std::vector<std::size_t> sizes{32, 128, 512, 1024, 2048};
+    if (argc > 1) {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    for (const std::size_t n : sizes) compare(n, threads);
+    return 0;
+}
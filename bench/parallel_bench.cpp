@@ -0,0 +1,48 @@
+/**
+ * parallel_bench
+ *
+ * Scaling of the chunked parallel drivers from 1 to N threads, against the serial versions.
+ * Expect memory bandwidth, not core count, to be the limit for splitting.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../basics/parallel.hpp"
+#include "bench.hpp"
+
+
+// 1, 2, 4 ... up to the hardware concurrency (always included)
+[[nodiscard]] auto threadCounts() -> std::vector<std::size_t> {
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> result;
+    for (std::size_t n = 1; n < hardware; n *= 2) result.push_back(n);
+    result.push_back(hardware);
+    return result;
+}
+
+// g++ -std=c++23 -O2 -pthread parallel_bench.cpp -o /tmp/parallel_bench && /tmp/parallel_bench
+int main() {
+    constexpr std::size_t size = 64 * 1024 * 1024;
+    const bench::Options options{.batches = 3, .minBatchTime = std::chrono::milliseconds(200)};
+
+    const std::string text = bench::repeat("Съешь же ещё этих мягких французских булок, да выпей чаю. Straße 早安 🐳\n", size);
+
+    bench::header(std::format("{} MB mixed text, serial", text.size() >> 20));
+    bench::run("toUpperCase", text.size(), [&] { return toUpperCase(text); }, options);
+    bench::run("splitIntoCodePoints", text.size(), [&] { return splitIntoCodePoints(text); }, options);
+    bench::run("splitString(' ')", text.size(), [&] { return splitString(text, ' '); }, options);
+
+    for (const std::size_t threads : threadCounts()) {
+        parallel::ThreadPool pool(threads);
+        bench::header(std::format("parallel, {} threads", threads));
+        bench::run("parallel::toUpperCase", text.size(), [&] { return parallel::toUpperCase(text, pool); }, options);
+        bench::run("parallel::splitIntoCodePoints", text.size(), [&] {
+            return parallel::splitIntoCodePoints(text, pool);
+        }, options);
+        bench::run("parallel::splitString(' ')", text.size(), [&] { return parallel::splitString(text, ' ', pool); }, options);
+    }
+
+    return 0;
+}
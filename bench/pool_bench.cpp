@@ -0,0 +1,109 @@
+/**
+ * pool_bench
+ *
+ * Allocation rate of 64-byte objects owned by a std::unique_ptr: new/delete (std::make_unique) against
+ * pool::ObjectPool (unique_ptr/pool.hpp), in millions of allocate + destroy pairs per second:
+ *  - one thread, each object destroyed right after it's created
+ *  - churn: every thread keeps 256 live objects and replaces them one at a time
+ *  - handoff: every thread creates batches of 1024 objects that the next thread destroys, the slots go back
+ *    through the lock-free list of their owner
+ */
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../unique_ptr/pool.hpp"
+#include "bench.hpp"
+
+
+struct Message {
+    std::uint64_t id;
+    std::array<char, 56> payload;
+
+    explicit Message(const std::uint64_t id) : id(id), payload{} { payload[0] = static_cast<char>(id); }
+};
+
+constexpr std::size_t operationsPerThread = 1 << 18;
+
+pool::ObjectPool<Message> messages;
+
+struct MakeUnique {
+    [[nodiscard]] auto operator()(const std::uint64_t id) const { return std::make_unique<Message>(id); }
+};
+
+struct MakePooled {
+    [[nodiscard]] auto operator()(const std::uint64_t id) const { return messages.make(id); }
+};
+
+template<typename Make>
+void single(const Make make) {
+    for (std::size_t i = 0; i < operationsPerThread; ++i) {
+        auto message = make(i);
+        bench::doNotOptimize(message->payload[0]);
+    }
+}
+
+template<typename Make>
+void churn(const Make make, const unsigned threads) {
+    std::vector<std::jthread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([make] {
+            std::vector<decltype(make(0))> live;
+            for (std::uint64_t i = 0; i < 256; ++i) live.push_back(make(i));
+            for (std::size_t i = 0; i < operationsPerThread; ++i) live[i % live.size()] = make(i);
+        });
+    }
+}
+
+template<typename Make>
+void handoff(const Make make, const unsigned threads) {
+    constexpr std::size_t batchSize = 1024;
+    std::vector<std::vector<decltype(make(0))>> batches(threads);
+    std::barrier sync(threads);
+    std::vector<std::jthread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (std::size_t round = 0; round < operationsPerThread / batchSize; ++round) {
+                for (std::uint64_t i = 0; i < batchSize; ++i) batches[t].push_back(make(i));
+                sync.arrive_and_wait();
+                auto received = std::move(batches[(t + 1) % threads]);
+                batches[(t + 1) % threads].clear();
+                sync.arrive_and_wait();
+                received.clear(); // destroyed on another thread than the one that made them
+            }
+        });
+    }
+}
+
+// g++ -std=c++20 -O2 pool_bench.cpp -o /tmp/pool_bench && /tmp/pool_bench
+int main() {
+    const unsigned threads = std::max(4u, std::thread::hardware_concurrency());
+    const bench::Options options{.batches = 5, .minBatchTime = std::chrono::milliseconds(100)};
+    std::vector<std::pair<std::string, double>> rates;
+    const auto run = [&](const std::string &name, const std::size_t operations, auto &&fn) {
+        rates.emplace_back(name, static_cast<double>(operations) * 1e3 / bench::run(name, 0, fn, options).nsPerOp);
+    };
+
+    bench::header(std::format("unique_ptr<Message>, {} bytes, {} threads", sizeof(Message), threads));
+    run("single thread, std::make_unique", operationsPerThread, [] { single(MakeUnique{}); });
+    run("single thread, ObjectPool::make", operationsPerThread, [] { single(MakePooled{}); });
+    run("churn, std::make_unique", threads * operationsPerThread, [&] { churn(MakeUnique{}, threads); });
+    run("churn, ObjectPool::make", threads * operationsPerThread, [&] { churn(MakePooled{}, threads); });
+    run("handoff, std::make_unique", threads * operationsPerThread, [&] { handoff(MakeUnique{}, threads); });
+    run("handoff, ObjectPool::make", threads * operationsPerThread, [&] { handoff(MakePooled{}, threads); });
+
+    std::cout << '\n';
+    for (const auto &[name, rate] : rates) std::cout << std::format("{:<48} {:>9.1f} M/s\n", name, rate);
+    return 0;
+}
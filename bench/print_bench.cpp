@@ -0,0 +1,95 @@
+/**
+ * print_bench
+ *
+ * One line "1, two, 3.14, 0" per call (and one with a std::string and a double that changes), to
+ * /dev/null: the recursive print of basics/variadic_template.cpp (std::cout << per argument, std::endl),
+ * printf, std::println and variadic::print (basics/variadic_print.hpp).
+ *
+ * The recursive print and variadic::print flush every line, like std::endl: one write() per call.
+ * printf and std::println leave the line in the stdio buffer, so they're also measured with fflush().
+ */
+
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <print>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../basics/variadic_print.hpp"
+#include "bench.hpp"
+
+
+template<typename T>
+void recursivePrint(T value) {
+    std::cout << value << std::endl;
+}
+
+template<typename T, typename... Args>
+void recursivePrint(T value, Args... args) {
+    std::cout << value << ", ";
+    recursivePrint(args...);
+}
+
+// stdout goes to /dev/null: the rows are collected and printed to stderr
+std::vector<std::pair<std::string, bench::Result>> results;
+
+// g++ -std=c++23 -O2 print_bench.cpp -o /tmp/print_bench && /tmp/print_bench
+int main() {
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) return 1;
+
+    const auto run = [](const std::string &group, const std::string_view name, const std::size_t bytes, auto &&fn) {
+        results.emplace_back(group, bench::run(name, bytes, fn));
+    };
+
+    const std::string literals = "1, two, 3.14, 0";
+    run(literals, "recursive print (std::cout, std::endl)", literals.size() + 1, [] {
+        recursivePrint(1, "two", 3.14f, false);
+    });
+    run(literals, "printf", literals.size() + 1, [] {
+        std::printf("%d, %s, %g, %d\n", 1, "two", 3.14f, false);
+    });
+    run(literals, "printf + fflush", literals.size() + 1, [] {
+        std::printf("%d, %s, %g, %d\n", 1, "two", 3.14f, false);
+        std::fflush(stdout);
+    });
+    run(literals, "std::println", literals.size() + 1, [] {
+        std::println("{}, {}, {:g}, {:d}", 1, "two", 3.14f, false);
+    });
+    run(literals, "std::println + fflush", literals.size() + 1, [] {
+        std::println("{}, {}, {:g}, {:d}", 1, "two", 3.14f, false);
+        std::fflush(stdout);
+    });
+    run(literals, "variadic::print", literals.size() + 1, [] {
+        variadic::print(1, "two", 3.14f, false);
+    });
+
+    const std::string name = "a name that is longer than the small string buffer";
+    double value = 0;
+    const std::string mixed = std::format("42, {}, {:g}, x", name, 1234.5678);
+    run(mixed, "recursive print (std::cout, std::endl)", mixed.size() + 1, [&] {
+        recursivePrint(42, name, value += 0.25, 'x');
+    });
+    run(mixed, "printf + fflush", mixed.size() + 1, [&] {
+        std::printf("%d, %s, %g, %c\n", 42, name.c_str(), value += 0.25, 'x');
+        std::fflush(stdout);
+    });
+    run(mixed, "std::println + fflush", mixed.size() + 1, [&] {
+        std::println("{}, {}, {:g}, {}", 42, name, value += 0.25, 'x');
+        std::fflush(stdout);
+    });
+    run(mixed, "variadic::print", mixed.size() + 1, [&] {
+        variadic::print(42, name, value += 0.25, 'x');
+    });
+
+    std::string title;
+    for (const auto &[group, result] : results) {
+        if (group != title) {
+            title = group;
+            std::cerr << std::format("\n## {}\n{:<48} {:>14} {:>12}\n", title, "benchmark", "ns/op", "MB/s");
+        }
+        std::cerr << std::format("{:<48} {:>14.1f} {:>12.1f}\n", result.name, result.nsPerOp, result.mbPerSec);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * span_print_bench
+ *
+ * Text output of 1M random ints and 1M random doubles: `std::cout << x << " "` (print_span in span.cpp),
+ * std::ostringstream, a plain std::to_chars loop and spans::toString / spans::print (cpp20/span_print.hpp).
+ * MB/s is text output. Output to stdout goes to /dev/null.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../cpp20/span_print.hpp"
+#include "bench.hpp"
+
+
+// stdout goes to /dev/null: the rows are collected and printed to stderr
+std::vector<std::pair<std::string, bench::Result>> results;
+
+template<typename T>
+void compare(const std::string &title, const std::vector<T> &values) {
+    const std::size_t textSize = spans::toString(values).size();
+    const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    const auto run = [&](const std::string_view name, auto &&fn) {
+        results.emplace_back(std::format("{}, {} bytes of text", title, textSize), bench::run(name, textSize, fn));
+    };
+
+    run("std::cout << x << \" \"", [&] {
+        for (const T x : values) std::cout << x << " ";
+        std::cout << "\n";
+    });
+    run("std::ostringstream", [&] {
+        std::ostringstream out;
+        for (const T x : values) out << x << ' ';
+        return out.view().size();
+    });
+    run("std::to_chars loop", [&] {
+        std::string out(values.size() * 32, '\0');
+        char *p = out.data();
+        for (const T x : values) {
+            p = std::to_chars(p, out.data() + out.size(), x).ptr;
+            *p++ = ' ';
+        }
+        out.resize(static_cast<std::size_t>(p - out.data()));
+        return out.size();
+    });
+    run("spans::toString", [&] {
+        return spans::toString(values).size();
+    });
+    run(std::format("spans::toString, {} threads", threads), [&] {
+        return spans::toString(values, {.threads = threads}).size();
+    });
+    run("spans::print", [&] {
+        spans::print(values);
+    });
+}
+
+// g++ -std=c++23 -O2 span_print_bench.cpp -o /tmp/span_print_bench && /tmp/span_print_bench
+int main() {
+    constexpr std::size_t count = 1 << 20;
+    std::mt19937_64 random(42);
+
+    std::vector<int> ints(count);
+    std::ranges::generate(ints, [&random] { return static_cast<int>(random()); });
+    std::vector<double> doubles(count);
+    std::ranges::generate(doubles, [&random] { return std::uniform_real_distribution(-1e6, 1e6)(random); });
+
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) return 1;
+    compare("1M ints", ints);
+    compare("1M doubles", doubles);
+
+    std::string title;
+    for (const auto &[group, result] : results) {
+        if (group != title) {
+            title = group;
+            std::cerr << std::format("\n## {}\n{:<48} {:>14} {:>12}\n", title, "benchmark", "ns/op", "MB/s");
+        }
+        std::cerr << std::format("{:<48} {:>14.1f} {:>12.1f}\n", result.name, result.nsPerOp, result.mbPerSec);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * split_bench
+ *
+ * Splitting many short lines: find() loop per call vs split::Splitter with a reused vector vs lazy fields.
+ */
+
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "../basics/strings.hpp"
+#include "bench.hpp"
+
+
+// The classic version: one find() per field, a new vector per line
+[[nodiscard]] auto findLoopSplit(const std::string_view &str, const std::string_view &delimiter) -> std::vector<std::string_view> {
+    std::vector<std::string_view> result;
+    std::size_t start = 0;
+    std::size_t end = str.find(delimiter);
+    while (end != std::string_view::npos) {
+        result.push_back(str.substr(start, end - start));
+        start = end + delimiter.size();
+        end = str.find(delimiter, start);
+    }
+    result.push_back(str.substr(start));
+    return result;
+}
+
+// g++ -std=c++23 -O2 split_bench.cpp -o /tmp/split_bench && /tmp/split_bench
+int main() {
+    constexpr std::size_t size = 256 * 1024;
+
+    const std::string csv = bench::repeat("2025-07-13,42,ok,3.14,,Stephen,sib.li,early,0x2A,1\n", size);
+    const std::string scoped = bench::repeat("std::ranges::views::split::inner::iterator\n", size);
+    const std::string cjk = bench::repeat("早安 🐳 hello 世界 早安 ¶ Hi 早安\n", size);
+
+    // Sum of field sizes keeps every field observed
+    const auto fieldBytes = [](const auto &fields) {
+        std::size_t total = 0;
+        for (const std::string_view field : fields) total += field.size();
+        return total;
+    };
+
+    const auto compare = [&](const char *name, const std::string &text, const split::Splitter &splitter,
+                             const std::string &delimiter) {
+        const std::vector<std::string_view> lines = splitString(text, '\n');
+        const std::size_t bytes = text.size();
+        bench::header(name);
+        bench::run("find() loop, new vector per line", bytes, [&] {
+            std::size_t total = 0;
+            for (const std::string_view line : lines) total += fieldBytes(findLoopSplit(line, delimiter));
+            return total;
+        });
+        bench::run("splitString(), new vector per line", bytes, [&] {
+            std::size_t total = 0;
+            for (const std::string_view line : lines) total += fieldBytes(splitString(line, delimiter));
+            return total;
+        });
+        bench::run("Splitter::splitInto(), reused vector", bytes, [&] {
+            std::vector<std::string_view> fields;
+            std::size_t total = 0;
+            for (const std::string_view line : lines) {
+                splitter.splitInto(line, fields);
+                total += fieldBytes(fields);
+            }
+            return total;
+        });
+        bench::run("Splitter::split(), lazy", bytes, [&] {
+            std::size_t total = 0;
+            for (const std::string_view line : lines) total += fieldBytes(splitter.split(line));
+            return total;
+        });
+        bench::run("std::views::split, lazy", bytes, [&] {
+            std::size_t total = 0;
+            for (const std::string_view line : lines) {
+                for (const auto field : line | std::views::split(std::string_view(delimiter))) {
+                    total += std::ranges::distance(field);
+                }
+            }
+            return total;
+        });
+    };
+
+    compare("csv, ','", csv, split::Splitter(','), ",");
+    compare("scoped names, \"::\"", scoped, split::Splitter("::"), "::");
+    compare("cjk, \"早安\"", cjk, split::Splitter("早安"), "早安");
+
+    // Long lines: one big buffer split at once
+    const split::Splitter comma(',');
+    bench::header("whole buffer, ','");
+    bench::run("find() loop", csv.size(), [&] { return findLoopSplit(csv, ",").size(); });
+    bench::run("Splitter::splitInto(), reused vector", csv.size(), [&, fields = std::vector<std::string_view>()]() mutable {
+        return comma.splitInto(csv, fields);
+    });
+    bench::run("Splitter::anyOf(\",\\n\")", csv.size(), [&, fields = std::vector<std::string_view>()]() mutable {
+        return split::Splitter::anyOf(",\n").splitInto(csv, fields);
+    });
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * stdout_bench
+ *
+ * Printing many short lines to stdout redirected to a file, a pipe and /dev/full:
+ * std::cout (with and without std::endl), printf, std::println and CheckedOutput.
+ *
+ * Only CheckedOutput notices /dev/full without a flush per line; "errors" counts what each one reported.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#if __has_include(<print>)
+#include <print>
+#endif
+
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../stdout_writeability/checked_stdout.hpp"
+#include "bench.hpp"
+
+
+constexpr int lineCount = 100'000;
+
+// Point fd 1 at `target` for the duration of fn()
+template<typename Fn>
+auto withStdout(const int target, Fn &&fn) {
+    std::cout.flush();
+    std::fflush(stdout);
+    const int saved = ::dup(STDOUT_FILENO);
+    ::dup2(target, STDOUT_FILENO);
+    auto result = fn();
+    ::dup2(saved, STDOUT_FILENO);
+    ::close(saved);
+    return result;
+}
+
+// Each sink prints lineCount lines and returns whether it noticed a write error
+struct Sink {
+    const char *name;
+    bool (*print)();
+};
+
+const Sink sinks[] = {
+    {"std::cout << std::endl", [] {
+        for (int i = 0; i < lineCount; ++i) std::cout << "line " << i << ' ' << i * 7 << std::endl;
+        const bool failed = std::cout.fail();
+        std::cout.clear();
+        return failed;
+    }},
+    {"std::cout << '\\n'", [] {
+        for (int i = 0; i < lineCount; ++i) std::cout << "line " << i << ' ' << i * 7 << '\n';
+        std::cout.flush();
+        const bool failed = std::cout.fail();
+        std::cout.clear();
+        return failed;
+    }},
+    {"printf", [] {
+        for (int i = 0; i < lineCount; ++i) std::printf("line %d %d\n", i, i * 7);
+        const bool failed = std::fflush(stdout) != 0;
+        std::clearerr(stdout);
+        return failed;
+    }},
+#if __cpp_lib_print
+    {"std::println", [] {
+        bool failed = false;
+        for (int i = 0; i < lineCount; ++i) {
+            try {
+                std::println("line {} {}", i, i * 7);
+            } catch (const std::system_error &) {
+                failed = true;
+            }
+        }
+        std::fflush(stdout);
+        std::clearerr(stdout);
+        return failed;
+    }},
+#endif
+    {"CheckedOutput", [] {
+        bool failed = false;
+        {
+            CheckedOutput out(STDOUT_FILENO, {.onError = [&](const std::error_code &) { failed = true; }});
+            for (int i = 0; i < lineCount; ++i) out.println("line {} {}", i, i * 7);
+        }
+        return failed;
+    }},
+};
+
+void runAll(const std::string_view title, const int target, const std::size_t bytes) {
+    const bench::Options options{.batches = 3, .minBatchTime = std::chrono::milliseconds(50)};
+    bench::header(title);
+    for (const Sink &sink : sinks) {
+        bench::run(sink.name, bytes, [&] { return withStdout(target, sink.print); }, options);
+    }
+}
+
+// g++ -std=c++23 -O2 -pthread stdout_bench.cpp -o /tmp/stdout_bench && /tmp/stdout_bench
+int main() {
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cout.flush();
+
+    std::size_t bytes = 0;
+    for (int i = 0; i < lineCount; ++i) bytes += std::format("line {} {}\n", i, i * 7).size();
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "stdout_bench.txt";
+    const int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    runAll("file", file, bytes);
+    ::close(file);
+    std::filesystem::remove(path);
+
+    // Pipe with a reader thread draining it
+    int pipeFds[2];
+    if (::pipe(pipeFds) != 0) return 1;
+    std::thread reader([fd = pipeFds[0]] {
+        char buffer[64 * 1024];
+        while (::read(fd, buffer, sizeof buffer) > 0) {}
+    });
+    runAll("pipe", pipeFds[1], bytes);
+    ::close(pipeFds[1]);
+    reader.join();
+    ::close(pipeFds[0]);
+
+    const int full = ::open("/dev/full", O_WRONLY);
+    if (full >= 0) {
+        runAll("/dev/full", full, bytes);
+        std::cout << "\nError noticed on /dev/full:\n";
+        for (const Sink &sink : sinks) {
+            std::cout << std::format("{:<48} {}\n", sink.name, withStdout(full, sink.print) ? "yes" : "no");
+        }
+        ::close(full);
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * strings_bench
+ *
+ * Every function of basics/strings.hpp on 1 MB of each corpus::Script (corpus.hpp), MB/s of UTF-8 input:
+ * splitting by space, by a UTF-8 delimiter and into code points, case mapping, decoding and encoding.
+ * The corpora are deterministic, so the JSON reports (BENCH_JSON=path) of two commits are comparable.
+ */
+
+#include <cstddef>
+#include <format>
+#include <string>
+
+#include "../basics/strings.hpp"
+#include "bench.hpp"
+#include "corpus.hpp"
+
+
+// g++ -std=c++23 -O2 strings_bench.cpp -o /tmp/strings_bench && /tmp/strings_bench
+int main() {
+    constexpr std::size_t size = 1 << 20;
+    const bench::Options options{.batches = 5, .minBatchTime = std::chrono::milliseconds(50)};
+
+    for (const corpus::Script script : corpus::scripts) {
+        const std::string text = corpus::generate(script, {.bytes = size});
+        const std::u32string wide = decodeUTF8(text);
+
+        bench::header(std::format("{} corpus, {} KB", corpus::name(script), text.size() / 1024));
+        bench::run("splitString(str, ' ')", text.size(), [&] { return splitString(text, ' '); }, options);
+        bench::run("splitString(str, \"\\n\")", text.size(), [&] { return splitString(text, "\n"); }, options);
+        bench::run("splitString(str), code points", text.size(), [&] { return splitString(text); }, options);
+        bench::run("splitIntoCodePoints", text.size(), [&] { return splitIntoCodePoints(text); }, options);
+        bench::run("toUpper, ASCII only", text.size(), [&] { return toUpper(text); }, options);
+        bench::run("toUpperCase", text.size(), [&] { return toUpperCase(text); }, options);
+        bench::run("toLowerCase", text.size(), [&] { return toLowerCase(text); }, options);
+        bench::run("foldCase", text.size(), [&] { return foldCase(text); }, options);
+        bench::run("decodeUTF8", text.size(), [&] { return decodeUTF8(text); }, options);
+        bench::run("encodeUTF8", text.size(), [&] { return encodeUTF8(wide); }, options);
+    }
+    return 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * async_log
+ *
+ * Asynchronous backend for console::log: the calling thread only copies the arguments into a bounded
+ * lock-free ring buffer, a background thread formats them and writes the text in large batches.
+ *
+ *  - multi-producer / single-consumer ring of fixed-size slots (Vyukov's bounded queue): one CAS per call,
+ *    no mutex, no allocation for small arguments, no I/O on the calling thread
+ *  - bounded memory: on overflow either block until the background thread catches up, or drop the record
+ *    (the number of dropped records is written to the log)
+ *  - each record is written as a whole line, lines from different threads don't interleave
+ *  - everything logged is written when the logger is destroyed (at exit for asyncLogger())
+ *
+ * Arguments are copied: C strings become std::string, other types are copy-constructed. Records that don't
+ * fit into a slot are formatted on the calling thread instead and queued as text.
+ *
+ * The printing itself is a callable passed by the caller, so that operator<< overloads visible at the
+ * call site (e.g. in the global namespace for std types) are used, see console::logAsync in concepts.cpp.
+ *
+ * Usage:
+ *  asyncLogger().log([](std::ostream &out, const auto &...values) { (out << ... << values); }, "x = ", 42);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+class AsyncLogger {
+public:
+    enum class Overflow : std::uint8_t {
+        block, // wait for free space: nothing is lost, but a slow output slows the callers down
+        drop,  // return right away: callers never wait, records are lost when the output can't keep up
+    };
+
+    struct Options {
+        std::size_t capacity = 8192;         // slots, rounded up to a power of 2
+        Overflow overflow = Overflow::block;
+        std::size_t batchBytes = 64 * 1024;  // write and flush the output after this much text
+    };
+
+    /**
+     * @param out where the background thread writes, must outlive the logger
+     * @param options ring size, overflow policy, batch size
+     */
+    AsyncLogger(std::ostream &out, const Options options) :
+        out_(out), options_(options), mask_(std::bit_ceil(std::max<std::size_t>(options.capacity, 2)) - 1),
+        slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) slots_[i].sequence.store(i, std::memory_order_relaxed);
+        thread_ = std::thread([this] { consume(); });
+    }
+
+    // Separate overload: GCC rejects "= {}" for a nested struct with default member initializers
+    explicit AsyncLogger(std::ostream &out = std::cout) : AsyncLogger(out, Options{}) {}
+
+    AsyncLogger(const AsyncLogger &) = delete;
+    auto operator=(const AsyncLogger &) -> AsyncLogger & = delete;
+
+    // Writes everything logged so far. No thread may log concurrently with the destruction.
+    ~AsyncLogger() {
+        stop_.store(true);
+        wake();
+        thread_.join();
+    }
+
+    /**
+     * Queue one line. `print(out, values...)` runs later on the background thread, with copies of the arguments.
+     *
+     * @param print stateless callable writing the values to a std::ostream
+     * @return false if the record was dropped (Overflow::drop and the ring is full)
+     */
+    template<typename Print, typename... Args>
+    auto log(const Print &print, const Args &...args) -> bool {
+        using Record = std::tuple<Print, Captured<Args>...>;
+        if constexpr (sizeof(Record) <= payloadSize && alignof(Record) <= alignof(std::max_align_t)) {
+            return push<Record>(print, args...);
+        } else {
+            // Too large for a slot: format here, queue the text
+            std::ostringstream text;
+            print(text, args...);
+            return push<std::tuple<PrintText, std::string>>(PrintText{}, std::move(text).str());
+        }
+    }
+
+    // Block until everything logged before this call is written to the output
+    void flush() {
+        const std::uint64_t target = tail_.load();
+        std::uint64_t written = written_.load();
+        while (written < target) {
+            wake();
+            written_.wait(written);
+            written = written_.load();
+        }
+    }
+
+    // Records lost with Overflow::drop so far
+    [[nodiscard]] auto dropped() const noexcept -> std::uint64_t { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t payloadSize = 224;
+
+    // Slots are a multiple of the cache line, so producers writing neighbouring slots don't share lines
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> sequence; // == position: free, == position + 1: ready to consume
+        void (*consume)(std::ostream &, std::byte *) = nullptr; // prints and destroys the record, nullptr: skip
+        alignas(std::max_align_t) std::byte payload[payloadSize];
+    };
+
+    // C strings may point into the caller's buffers: copy the characters
+    template<typename T>
+    using Captured = std::conditional_t<
+        std::is_same_v<std::decay_t<T>, char *> || std::is_same_v<std::decay_t<T>, const char *>,
+        std::string,
+        std::decay_t<T>>;
+
+    struct PrintText {
+        void operator()(std::ostream &out, const std::string &text) const { out << text; }
+    };
+
+    template<typename Record>
+    static void consumeRecord(std::ostream &out, std::byte *payload) {
+        auto *record = std::launder(reinterpret_cast<Record *>(payload));
+        try {
+            std::apply([&out](const auto &print, const auto &...values) { print(out, values...); }, *record);
+        } catch (...) {
+            out << "[async log: exception while printing]";
+        }
+        record->~Record();
+    }
+
+    template<typename Record, typename... Values>
+    auto push(Values &&...values) -> bool {
+        const std::uint64_t position = claim();
+        if (position == full) return false;
+
+        Slot &slot = slots_[position & mask_];
+        try {
+            ::new (slot.payload) Record(std::forward<Values>(values)...);
+            slot.consume = &consumeRecord<Record>;
+        } catch (...) {
+            // The slot is taken: publish it empty, the consumer would wait for it forever otherwise
+            slot.consume = nullptr;
+            publish(slot, position);
+            throw;
+        }
+        publish(slot, position);
+        return true;
+    }
+
+    static constexpr std::uint64_t full = UINT64_MAX;
+
+    // Reserve the next slot, blocks or returns `full` when there is none
+    auto claim() -> std::uint64_t {
+        std::uint64_t position = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            const Slot &slot = slots_[position & mask_];
+            const auto difference = static_cast<std::int64_t>(slot.sequence.load(std::memory_order_acquire) - position);
+            if (difference == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) return position;
+            } else if (difference < 0) {
+                // Still holds the record from one lap ago
+                if (options_.overflow == Overflow::drop) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return full;
+                }
+                waitForSpace(slot, position);
+                position = tail_.load(std::memory_order_relaxed);
+            } else {
+                // Another producer took it
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(Slot &slot, const std::uint64_t position) {
+        // seq_cst pairs with the consumer going to sleep: either it sees the record, or we see it sleeping
+        slot.sequence.store(position + 1);
+        if (sleeping_.load()) wake();
+    }
+
+    void wake() {
+        wakeups_.fetch_add(1);
+        wakeups_.notify_one();
+    }
+
+    void waitForSpace(const Slot &slot, const std::uint64_t position) {
+        blocked_.fetch_add(1);
+        const std::uint32_t freed = freed_.load();
+        // Re-check after announcing ourselves: the consumer notifies only when it sees blocked producers
+        if (static_cast<std::int64_t>(slot.sequence.load() - position) < 0) {
+            freed_.wait(freed);
+        }
+        blocked_.fetch_sub(1);
+    }
+
+    void signalFreed() {
+        freed_.fetch_add(1);
+        if (blocked_.load() > 0) freed_.notify_all();
+    }
+
+    [[nodiscard]] auto ready(const std::uint64_t head) const -> bool {
+        return slots_[head & mask_].sequence.load() == head + 1;
+    }
+
+    // Background thread: drain the ring into the batch, write the batch when it's large or the ring is empty
+    void consume() {
+        std::ostringstream batch;
+        std::uint64_t head = 0;
+        std::uint64_t droppedReported = 0;
+        // Blocked producers are woken after this many freed slots, not for each one: fewer context switches
+        const std::size_t signalEvery = std::max<std::size_t>(64, (mask_ + 1) / 8);
+
+        const auto write = [&] {
+            const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (dropped != droppedReported) {
+                batch << "[async log: " << dropped - droppedReported << " records dropped]\n";
+                droppedReported = dropped;
+            }
+            if (batch.tellp() > 0) {
+                out_.write(batch.view().data(), static_cast<std::streamsize>(batch.view().size()));
+                out_.flush();
+                batch.str(std::string());
+            }
+            written_.store(head);
+            written_.notify_all();
+        };
+
+        while (true) {
+            std::size_t count = 0;
+            while (ready(head)) {
+                Slot &slot = slots_[head & mask_];
+                if (slot.consume) {
+                    slot.consume(batch, slot.payload);
+                    batch << '\n';
+                }
+                slot.sequence.store(head + mask_ + 1, std::memory_order_release);
+                ++head;
+                if (++count % signalEvery == 0) signalFreed();
+                if (static_cast<std::size_t>(batch.tellp()) >= options_.batchBytes) write();
+            }
+            signalFreed();
+            write();
+
+            // Give the producers a moment before sleeping: a sleeping consumer costs them a wakeup syscall
+            for (int spin = 0; spin < 16 && !ready(head); ++spin) std::this_thread::yield();
+            if (ready(head)) continue;
+
+            const std::uint32_t wakeups = wakeups_.load();
+            sleeping_.store(true);
+            if (!ready(head)) {
+                if (stop_.load()) break;
+                wakeups_.wait(wakeups);
+            }
+            sleeping_.store(false);
+        }
+    }
+
+    std::ostream &out_;
+    Options options_;
+    std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<std::uint64_t> tail_ = 0;     // next position to claim
+    alignas(64) std::atomic<std::uint64_t> written_ = 0;  // positions before this one are written
+    std::atomic<std::uint64_t> dropped_ = 0;
+    std::atomic<std::uint32_t> wakeups_ = 0;
+    std::atomic<std::uint32_t> freed_ = 0;
+    std::atomic<std::uint32_t> blocked_ = 0;
+    std::atomic<bool> sleeping_ = false;
+    std::atomic<bool> stop_ = false;
+    std::thread thread_;
+};
+
+
+// Process-wide logger on std::cout, drained at exit
+[[nodiscard]] inline auto asyncLogger() -> AsyncLogger & {
+    static AsyncLogger logger(std::cout);
+    return logger;
+}
@@ -0,0 +1,567 @@
+/**
+ * binary_log
+ *
+ * Deferred formatting: log calls write the call site ID and the raw argument bytes, text is rendered
+ * offline by a decoder (binary_log_decode.cpp), or later in the same process with binlog::decode().
+ *
+ *  - the format string and the argument types are static per call site: they are registered once and
+ *    written to the log once, the first time the site is used with a Writer
+ *  - integers are written as varints (small values take one or two bytes), floats as they are, strings as
+ *    a length + bytes, std::variant (e.g. IntOrString) as the index + the active alternative
+ *  - values are decoded as operator<< prints them by default (bools as 1 / 0, 6 significant digits). A custom
+ *    operator<< is not known offline: for a variant, specialize binlog::variantLabels with the text it writes
+ *    before each alternative (e.g. "i_" and "s_"), the labels are stored with the call site
+ *  - other Printable types are formatted to text at the call, with operator<< found by ADL (the slow path)
+ *
+ * No text formatting on the hot path: a log call is a few stores into a buffer, the log is several times
+ * smaller than the text (the constant parts of the message are not repeated).
+ *
+ * A Writer belongs to one thread: use one Writer (and file) per thread, or lock around it.
+ * The decoder expects the byte order of the machine that wrote the log.
+ *
+ * Usage:
+ *  binlog::Writer writer("events.binlog");
+ *  binlog::log<"user {} bought {} for {}">(writer, userName, count, price);
+ *
+ *  $ ./binary_log_decode events.binlog
+ *  user Alice bought 3 for 9.99
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "../file_write/batch_writer.hpp"
+
+
+namespace binlog {
+
+    // File header, followed by records
+    inline constexpr std::string_view magic = "BINLOG1\n";
+
+    /**
+     * Text the decoder writes before each alternative of a std::variant, none by default.
+     * Specialize to decode a variant as its operator<< prints it:
+     *  template<> inline constexpr std::array<std::string_view, 2> binlog::variantLabels<IntOrString>{"i_", "s_"};
+     */
+    template<typename Variant>
+    inline constexpr std::array<std::string_view, std::variant_size_v<Variant>> variantLabels{};
+
+    /**
+     * Compile-time format string, "{}" for each argument, "{{" and "}}" for braces.
+     * Used as a template parameter: binlog::log<"x = {}">(writer, x)
+     */
+    template<std::size_t N>
+    struct Format {
+        char text[N];
+
+        consteval Format(const char (&string)[N]) { std::copy_n(string, N, text); }
+
+        [[nodiscard]] constexpr auto view() const -> std::string_view { return {text, N - 1}; }
+
+        [[nodiscard]] consteval auto placeholders() const -> std::size_t {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i + 1 < N - 1; ++i) {
+                if ((text[i] == '{' && text[i + 1] == '{') || (text[i] == '}' && text[i + 1] == '}')) {
+                    ++i;
+                } else if (text[i] == '{' && text[i + 1] == '}') {
+                    ++count;
+                    ++i;
+                }
+            }
+            return count;
+        }
+    };
+
+    namespace detail {
+
+        [[nodiscard]] constexpr auto varintSize(std::uint64_t value) -> std::size_t {
+            std::size_t size = 1;
+            while (value >= 0x80) {
+                value >>= 7;
+                ++size;
+            }
+            return size;
+        }
+
+        // LEB128
+        inline auto writeVarint(char *p, std::uint64_t value) -> char * {
+            while (value >= 0x80) {
+                *p++ = static_cast<char>(value | 0x80);
+                value >>= 7;
+            }
+            *p++ = static_cast<char>(value);
+            return p;
+        }
+
+        [[nodiscard]] constexpr auto zigzag(const std::int64_t value) -> std::uint64_t {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        [[nodiscard]] constexpr auto unzigzag(const std::uint64_t value) -> std::int64_t {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        /**
+         * Encoding of one argument type: maxSize() bytes are reserved, encode() returns the end.
+         *
+         * Type tags (written with the call site):
+         *  b bool, c char, s/S int16/uint16, i/I int32/uint32, l/L int64/uint64 (varints, signed ones zigzag),
+         *  f float, d double,
+         *  z string, vN<tags> std::variant with N alternatives, each tag may be preceded by its label in quotes
+         */
+        template<typename T>
+        struct Codec;
+
+        template<typename T> requires std::is_arithmetic_v<T>
+        struct Codec<T> {
+            // long double is stored as double: printed with the default stream precision anyway
+            using Stored = std::conditional_t<std::is_same_v<T, long double>, double, T>;
+
+            static void tag(std::string &tags) {
+                if constexpr (std::is_same_v<T, bool>) {
+                    tags += 'b';
+                } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+                    tags += 'c';
+                } else if constexpr (std::is_floating_point_v<T>) {
+                    tags += sizeof(Stored) == 4 ? 'f' : 'd';
+                } else {
+                    static_assert(sizeof(T) >= 2 && sizeof(T) <= 8, "unsupported integer size");
+                    constexpr char signedTags[] = "?s?i???l";
+                    constexpr char unsignedTags[] = "?S?I???L";
+                    tags += std::is_signed_v<T> ? signedTags[sizeof(T) - 1] : unsignedTags[sizeof(T) - 1];
+                }
+            }
+
+            static constexpr bool isVarint = sizeof(T) >= 2 && std::is_integral_v<T>;
+
+            [[nodiscard]] static constexpr auto maxSize(const T &) -> std::size_t {
+                return isVarint ? (sizeof(T) * 8 + 6) / 7 : sizeof(Stored);
+            }
+
+            static auto encode(char *p, const T &value) -> char * {
+                if constexpr (isVarint && std::is_signed_v<T>) {
+                    return writeVarint(p, zigzag(value));
+                } else if constexpr (isVarint) {
+                    return writeVarint(p, value);
+                } else {
+                    const auto stored = static_cast<Stored>(value);
+                    std::memcpy(p, &stored, sizeof(Stored));
+                    return p + sizeof(Stored);
+                }
+            }
+        };
+
+        template<>
+        struct Codec<std::string_view> {
+            static void tag(std::string &tags) { tags += 'z'; }
+
+            [[nodiscard]] static auto maxSize(const std::string_view &value) -> std::size_t {
+                return varintSize(value.size()) + value.size();
+            }
+
+            static auto encode(char *p, const std::string_view &value) -> char * {
+                p = writeVarint(p, value.size());
+                std::memcpy(p, value.data(), value.size());
+                return p + value.size();
+            }
+        };
+
+        template<>
+        struct Codec<std::string> : Codec<std::string_view> {};
+
+        template<typename... Ts>
+        struct Codec<std::variant<Ts...>> {
+            static_assert(sizeof...(Ts) <= 9, "variants of up to 9 alternatives");
+
+            [[nodiscard]] static consteval auto unquoted() -> bool {
+                for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+                    if (variantLabels<std::variant<Ts...>>[i].find('\'') != std::string_view::npos) return false;
+                }
+                return true;
+            }
+            static_assert(unquoted(), "binlog::variantLabels: no quotes in a label");
+
+            static void tag(std::string &tags) {
+                tags += 'v';
+                tags += static_cast<char>('0' + sizeof...(Ts));
+                std::size_t index = 0;
+                ((label(tags, variantLabels<std::variant<Ts...>>[index++]), Codec<Ts>::tag(tags)), ...);
+            }
+
+            static void label(std::string &tags, const std::string_view text) {
+                if (text.empty()) return;
+                tags += '\'';
+                tags += text;
+                tags += '\'';
+            }
+
+            [[nodiscard]] static auto maxSize(const std::variant<Ts...> &value) -> std::size_t {
+                return 1 + std::visit([]<typename T>(const T &v) { return Codec<T>::maxSize(v); }, value);
+            }
+
+            static auto encode(char *p, const std::variant<Ts...> &value) -> char * {
+                *p++ = static_cast<char>(value.index());
+                return std::visit([p]<typename T>(const T &v) { return Codec<T>::encode(p, v); }, value);
+            }
+        };
+
+        template<typename T>
+        inline constexpr bool isVariant = false;
+        template<typename... Ts>
+        inline constexpr bool isVariant<std::variant<Ts...>> = true;
+
+        // What is written for an argument: numbers and variants as they are, strings as views, the rest as text
+        template<typename T>
+        [[nodiscard]] auto encodable(const T &value) -> decltype(auto) {
+            if constexpr (std::is_arithmetic_v<T>) {
+                return value;
+            } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+                return std::string_view(value);
+            } else if constexpr (isVariant<T>) {
+                return (value);
+            } else {
+                std::ostringstream text;
+                text << value;
+                return std::move(text).str();
+            }
+        }
+
+        struct Site {
+            std::string_view format;
+            std::string tags;
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<Site> sites;
+        };
+
+        [[nodiscard]] inline auto registry() -> Registry & {
+            static Registry registry;
+            return registry;
+        }
+
+        [[nodiscard]] inline auto site(const std::uint32_t id) -> Site {
+            Registry &sites = registry();
+            const std::lock_guard lock(sites.mutex);
+            return sites.sites[id];
+        }
+
+        // One ID per format string and argument types, assigned on first use
+        template<Format format, typename... Encoded>
+        [[nodiscard]] auto siteId() -> std::uint32_t {
+            static const std::uint32_t id = [] {
+                Site site{format.view(), {}};
+                (Codec<Encoded>::tag(site.tags), ...);
+                Registry &sites = registry();
+                const std::lock_guard lock(sites.mutex);
+                sites.sites.push_back(std::move(site));
+                return static_cast<std::uint32_t>(sites.sites.size() - 1);
+            }();
+            return id;
+        }
+
+    }
+
+    /**
+     * Binary log file. Records:
+     *  varint 0, varint site ID, varint length + format string, varint length + type tags: call site definition
+     *  varint site ID + 1, arguments: log record
+     */
+    class Writer {
+    public:
+        /**
+         * @param path log file, truncated
+         * @param bufferSize bytes collected before a write()
+         * @throws std::system_error if the file can't be opened
+         */
+        explicit Writer(const std::filesystem::path &path, const std::size_t bufferSize = 64 * 1024) :
+            file_(path, {.bufferSize = bufferSize}), capacity_(std::max<std::size_t>(bufferSize, 64)),
+            buffer_(std::make_unique_for_overwrite<char[]>(capacity_)) {
+            file_.write(magic);
+        }
+
+        Writer(const Writer &) = delete;
+        auto operator=(const Writer &) -> Writer & = delete;
+
+        // Writes the rest, errors are lost: call close() to see them
+        ~Writer() {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+
+        /**
+         * Append one record, used by binlog::log().
+         *
+         * @throws std::system_error if a write fails
+         */
+        template<typename... Encoded>
+        void write(const std::uint32_t id, const Encoded &...values) {
+            if (id >= defined_.size() || !defined_[id]) define(id);
+
+            const std::size_t maxSize = detail::varintSize(id + 1) + (detail::Codec<Encoded>::maxSize(values) + ... + 0);
+            const auto encode = [&](char *p) {
+                p = detail::writeVarint(p, id + 1);
+                ((p = detail::Codec<Encoded>::encode(p, values)), ...);
+                return p;
+            };
+
+            if (used_ + maxSize > capacity_) {
+                flush();
+                if (maxSize > capacity_) {
+                    std::string large(maxSize, '\0');
+                    large.resize(static_cast<std::size_t>(encode(large.data()) - large.data()));
+                    file_.write(large);
+                    return;
+                }
+            }
+            char *start = buffer_.get() + used_;
+            used_ += static_cast<std::size_t>(encode(start) - start);
+        }
+
+        void flush() {
+            file_.write(std::string_view(buffer_.get(), used_));
+            used_ = 0;
+            file_.flush();
+        }
+
+        // @throws std::system_error on a write or close error
+        void close() {
+            if (used_ > 0) flush();
+            file_.close();
+        }
+
+    private:
+        void define(const std::uint32_t id) {
+            const detail::Site site = detail::site(id);
+            std::string record(1, '\0');
+            record.resize(1 + 10 * 3 + site.format.size() + site.tags.size());
+            char *p = detail::writeVarint(record.data() + 1, id);
+            p = detail::Codec<std::string_view>::encode(p, site.format);
+            p = detail::Codec<std::string_view>::encode(p, site.tags);
+            record.resize(static_cast<std::size_t>(p - record.data()));
+
+            flush();
+            file_.write(record);
+            if (id >= defined_.size()) defined_.resize(id + 1);
+            defined_[id] = true;
+        }
+
+        BatchWriter file_;
+        std::size_t capacity_;
+        std::unique_ptr<char[]> buffer_;
+        std::size_t used_ = 0;
+        std::vector<bool> defined_;
+    };
+
+    /**
+     * Log a record: only the call site ID and the argument bytes are written.
+     *
+     * @tparam format "{}" per argument
+     * @throws std::system_error if a write fails
+     */
+    template<Format format, typename... Args>
+    void log(Writer &writer, const Args &...args) {
+        static_assert(format.placeholders() == sizeof...(Args), "binlog::log: one {} per argument");
+        writer.write(detail::siteId<format, std::remove_cvref_t<decltype(detail::encodable(args))>...>(),
+                     detail::encodable(args)...);
+    }
+
+    namespace detail {
+
+        struct Reader {
+            std::string_view data;
+            std::size_t position = 0;
+
+            [[noreturn]] void fail(const char *what) const {
+                throw std::runtime_error("binary log: " + std::string(what) + " at offset " + std::to_string(position));
+            }
+
+            auto varint() -> std::uint64_t {
+                std::uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    if (position >= data.size()) fail("truncated record");
+                    const auto byte = static_cast<unsigned char>(data[position++]);
+                    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                    if (byte < 0x80) return value;
+                }
+                fail("bad varint");
+            }
+
+            auto bytes(const std::size_t size) -> std::string_view {
+                if (data.size() - position < size) fail("truncated record");
+                const std::string_view result = data.substr(position, size);
+                position += size;
+                return result;
+            }
+
+            template<typename T>
+            auto value() -> T {
+                T result;
+                std::memcpy(&result, bytes(sizeof(T)).data(), sizeof(T));
+                return result;
+            }
+        };
+
+        // The label in quotes at the start of `tags`, if any
+        inline auto label(std::string_view tags) -> std::string_view {
+            if (tags.empty() || tags[0] != '\'') return {};
+            const std::size_t end = tags.find('\'', 1);
+            return end == std::string_view::npos ? tags : tags.substr(0, end + 1);
+        }
+
+        // Past the type tag at `tags`, and its label
+        inline auto skipTag(std::string_view tags) -> std::string_view {
+            tags.remove_prefix(label(tags).size());
+            if (tags.empty()) return tags;
+            if (tags[0] != 'v' || tags.size() < 2) return tags.substr(1);
+            const int count = tags[1] - '0';
+            tags.remove_prefix(2);
+            for (int i = 0; i < count; ++i) tags = skipTag(tags);
+            return tags;
+        }
+
+        template<typename T>
+        void appendNumber(std::string &text, const T value) {
+            char digits[32];
+            std::to_chars_result result;
+            if constexpr (std::is_floating_point_v<T>) {
+                // Same as operator<< with the default stream precision
+                result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+            } else {
+                result = std::to_chars(digits, digits + sizeof(digits), value);
+            }
+            text.append(digits, result.ptr);
+        }
+
+        // Append one argument as operator<< would have printed it, return the remaining tags
+        inline auto render(Reader &reader, std::string_view tags, std::string &text) -> std::string_view {
+            if (const std::string_view quoted = label(tags); !quoted.empty()) {
+                if (quoted.size() < 2 || quoted.back() != '\'') reader.fail("unterminated label");
+                text += quoted.substr(1, quoted.size() - 2);
+                tags.remove_prefix(quoted.size());
+            }
+            if (tags.empty()) reader.fail("more placeholders than arguments");
+            switch (tags[0]) {
+                case 'b': {
+                    // Not read as a bool: any other byte than 0 or 1 would be an invalid bool value
+                    const auto value = reader.value<unsigned char>();
+                    if (value > 1) reader.fail("bad bool");
+                    text += value ? '1' : '0';
+                    break;
+                }
+                case 'c': text += reader.value<char>(); break;
+                case 's':
+                case 'i':
+                case 'l': appendNumber(text, unzigzag(reader.varint())); break;
+                case 'S':
+                case 'I':
+                case 'L': appendNumber(text, reader.varint()); break;
+                case 'f': appendNumber(text, reader.value<float>()); break;
+                case 'd': appendNumber(text, reader.value<double>()); break;
+                case 'z': text += reader.bytes(reader.varint()); break;
+                case 'v': {
+                    const auto index = static_cast<unsigned char>(reader.bytes(1)[0]);
+                    if (tags.size() < 2 || index >= tags[1] - '0') reader.fail("bad variant index");
+                    std::string_view alternative = tags.substr(2);
+                    for (unsigned i = 0; i < index; ++i) alternative = skipTag(alternative);
+                    render(reader, alternative, text);
+                    return skipTag(tags);
+                }
+                default: reader.fail("unknown type tag");
+            }
+            return tags.substr(1);
+        }
+
+    }
+
+    /**
+     * Render a binary log as text, one line per record.
+     *
+     * @param data whole log file, e.g. a MappedFile
+     * @param out text output, written in large blocks
+     * @return number of records
+     * @throws std::runtime_error with the offset if the log is malformed or truncated
+     */
+    inline auto decode(const std::string_view data, std::ostream &out) -> std::size_t {
+        constexpr std::uint64_t maxSites = 1 << 20;
+        detail::Reader reader{data};
+        if (!data.starts_with(magic)) reader.fail("not a binary log");
+        reader.position = magic.size();
+
+        // Per call site: the constant text around the placeholders, braces unescaped, and the argument tags
+        struct DecodedSite {
+            std::vector<std::string> literals;
+            std::string tags;
+        };
+        std::vector<DecodedSite> sites;
+        std::string text;
+        text.reserve(64 * 1024 + 4096);
+        std::size_t records = 0;
+        while (reader.position < data.size()) {
+            const std::uint64_t kind = reader.varint();
+            if (kind == 0) {
+                const std::uint64_t id = reader.varint();
+                // IDs are assigned in order to the call sites of the program: a huge one is a corrupt log
+                if (id >= maxSites) reader.fail("bad call site id");
+                const std::string_view format = reader.bytes(reader.varint());
+                DecodedSite site{{std::string()}, std::string(reader.bytes(reader.varint()))};
+                for (std::size_t i = 0; i < format.size(); ++i) {
+                    const char next = i + 1 < format.size() ? format[i + 1] : '\0';
+                    if (format[i] == '{' && next == '}') {
+                        site.literals.emplace_back();
+                        ++i;
+                    } else {
+                        site.literals.back() += format[i];
+                        if ((format[i] == '{' || format[i] == '}') && next == format[i]) ++i;
+                    }
+                }
+                std::size_t arguments = 0;
+                for (std::string_view tags = site.tags; !tags.empty(); tags = detail::skipTag(tags)) ++arguments;
+                if (arguments != site.literals.size() - 1) reader.fail("format doesn't match the arguments");
+                if (id >= sites.size()) sites.resize(id + 1);
+                sites[id] = std::move(site);
+                continue;
+            }
+
+            const std::uint64_t id = kind - 1;
+            if (id >= sites.size() || sites[id].literals.empty()) reader.fail("undefined call site");
+            const DecodedSite &site = sites[id];
+            std::string_view tags = site.tags;
+            text += site.literals[0];
+            for (std::size_t i = 1; i < site.literals.size(); ++i) {
+                tags = detail::render(reader, tags, text);
+                text += site.literals[i];
+            }
+            text += '\n';
+            ++records;
+
+            if (text.size() >= 64 * 1024) {
+                out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                text.clear();
+            }
+        }
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return records;
+    }
+
+}
@@ -0,0 +1,41 @@
+/**
+ * binary_log_decode
+ *
+ * Offline decoder for binary_log.hpp logs: renders each record as a text line on stdout.
+ */
+
+
+#include <cstdio>
+#include <exception>
+#include <iostream>
+
+#include "../file_read/mapped_file.hpp"
+#include "binary_log.hpp"
+
+// g++ -std=c++20 -O2 binary_log_decode.cpp -o binary_log_decode
+// ./binary_log_decode events.binlog [more.binlog ...] > events.log
+int main(const int argc, const char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " file.binlog [...]\n";
+        return 2;
+    }
+
+    // Plain '\n' and one large buffer: the output can be big
+    std::ios::sync_with_stdio(false);
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const MappedFile file(argv[i]);
+            binlog::decode(file, std::cout);
+        }
+        std::cout.flush();
+    } catch (const std::exception &error) {
+        std::cout.flush();
+        std::cerr << argv[0] << ": " << error.what() << '\n';
+        return 1;
+    }
+    if (std::cout.fail()) {
+        std::cerr << argv[0] << ": failed writing to stdout\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,9 +1,24 @@
+#include <array>
+#include <charconv>
 #include <concepts>
+#include <filesystem>
+#include <format>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <string>
 #include <variant>
 #include <set>
+#include <thread>
 #include <unordered_set>
+#include <vector>
+
+#include "async_log.hpp"
+#include "binary_log.hpp"
+#include "flat_hash.hpp"
+#include "flat_set.hpp"
+#include "int_or_string.hpp"
+#include "../file_read/mapped_file.hpp"
 
 // Operator << overload for std::unordered_set<std::string>
 // Should be defined BEFORE the Printable concept definition.
@@ -20,31 +35,6 @@ std::ostream& operator<<(std::ostream& out, const std::unordered_set<std::string
 }
 
 
-
-// IntOrString typesafe union with std::variant
-using IntOrString = std::variant<int, std::string>;
-
-// Custom comparison operator for std::set compatibility
-struct IntOrStringComparator {
-    bool operator()(const IntOrString& a, const IntOrString& b) const noexcept {
-        // Define a consistent ordering for different types:
-        // - Integers come before strings.
-        // - Within the same type, use natural ordering.
-
-        if (a.index() == 0 && b.index() == 0) { // Both are int
-            return std::get<int>(a) < std::get<int>(b);
-        } else if (a.index() == 1 && b.index() == 1) { // Both are std::string
-            return std::get<std::string>(a) < std::get<std::string>(b);
-        } else if (a.index() == 0 && b.index() == 1) { // a is int, b is string
-            return true; // int comes before string
-        } else if (a.index() == 1 && b.index() == 0) { // a is string, b is int
-            return false; // string comes after int
-        }
-        // This should not be reached:
-        return false;
-    }
-};
-
 // Templated hash for IntOrString (for unordered_set compatibility)
 template<>
 struct std::hash<IntOrString> {
@@ -73,6 +63,10 @@ std::ostream& operator<<(std::ostream& out, const IntOrString& val) {
     return out;
 };
 
+// Decode IntOrString from a binary log as operator<< prints it
+template<>
+inline constexpr std::array<std::string_view, 2> binlog::variantLabels<IntOrString>{"i_", "s_"};
+
 // Different Printable implementation for ordered sets of type IntOrString
 std::ostream& operator<<(std::ostream& out, const std::set<IntOrString, IntOrStringComparator>& set) {
     for (auto iter = set.begin(); iter != set.end(); ++iter) {
@@ -93,10 +87,76 @@ concept Printable = requires(std::ostream& os, const T& obj) {
 // Log function template using the Printable concept.
 // Flushes the buffer (intentionally).
 namespace console {
+    // Same text as operator<< above, without a stream:
+    // - the sets and IntOrString element by element (no std::formatter specialization for std types:
+    //   undefined behavior, and C++23 already formats ranges as {"UP", "DOWN"})
+    // - numbers with std::to_chars and the stream defaults: 6 significant digits, bools as 1 / 0,
+    //   signed and unsigned char as characters
+    // - types with their own std::formatter (Ink) straight into the buffer, other Printables through operator<<
+    template<Printable T>
+    void append(std::string& buffer, const T& obj) {
+        if constexpr (std::same_as<T, std::unordered_set<std::string>>) {
+            bool isFirst = true;
+            for (const auto& item : obj) {
+                if (!isFirst) buffer += ", ";
+                buffer += item;
+                isFirst = false;
+            }
+        } else if constexpr (std::same_as<T, std::set<IntOrString, IntOrStringComparator>>) {
+            std::size_t index = 0;
+            for (const auto& item : obj) {
+                append(buffer, index++);
+                buffer += ": ";
+                append(buffer, item);
+                buffer += "; ";
+            }
+        } else if constexpr (std::same_as<T, IntOrString>) {
+            if (const int* number = std::get_if<int>(&obj)) {
+                buffer += "i_";
+                append(buffer, *number);
+            } else {
+                buffer += "s_";
+                buffer += std::get<std::string>(obj);
+            }
+        } else if constexpr (std::same_as<T, bool>) {
+            buffer += obj ? '1' : '0';
+        } else if constexpr (std::same_as<T, char> || std::same_as<T, signed char> || std::same_as<T, unsigned char>) {
+            buffer += static_cast<char>(obj);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            char text[64];
+            std::to_chars_result result;
+            if constexpr (std::floating_point<T>) {
+                result = std::to_chars(text, text + sizeof(text), obj, std::chars_format::general, 6);
+            } else {
+                result = std::to_chars(text, text + sizeof(text), obj);
+            }
+            buffer.append(text, result.ptr);
+        } else if constexpr (std::formattable<T, char>) {
+            std::format_to(std::back_inserter(buffer), "{}", obj);
+        } else {
+            thread_local std::ostringstream stream;
+            stream.str({});
+            stream << obj;
+            buffer += stream.view();
+        }
+    }
+
+    // The whole line is built in a reused per-thread buffer, then written at once
     template<Printable... Args>
     void log(const Args&... objs) {
-        // Fold expression to print all arguments
-        (std::cout << ... << objs) << std::endl;
+        thread_local std::string buffer;
+        buffer.clear();
+        (append(buffer, objs), ...);
+        buffer += '\n';
+        std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size())).flush();
+    }
+
+    // Asynchronous version: the calling thread only copies the arguments into a lock-free ring buffer,
+    // a background thread formats and writes them in batches, no flush per call.
+    // The printing lambda is defined here, so it sees the operator<< overloads above.
+    template<Printable... Args>
+    void logAsync(const Args&... objs) {
+        asyncLogger().log([](std::ostream& out, const auto&... values) { (out << ... << values); }, objs...);
     }
 }
 
@@ -116,6 +176,8 @@ public:
     explicit Ink(std::string color) : color(std::move(color)) {}
     // Printable friend: the non-member function operator<< will have access to private members
     friend std::ostream& operator<<(std::ostream& out, const Ink& ink);
+    // Same for the formatter
+    friend struct std::formatter<Ink>;
 };
 
 // Overload the << operator to make Ink Printable.
@@ -125,6 +187,15 @@ std::ostream& operator<<(std::ostream& out, const Ink& ink)
     return out << "Ink { color: " << ink.color << " }";
 }
 
+template<>
+struct std::formatter<Ink> {
+    constexpr auto parse(std::format_parse_context& context) { return context.begin(); }
+
+    auto format(const Ink& ink, std::format_context& context) const {
+        return std::format_to(context.out(), "Ink {{ color: {} }}", ink.color);
+    }
+};
+
 // Usage:
 int main() {
     console::log("Events: ", getUnorderedSet());
@@ -138,5 +209,45 @@ int main() {
     const std::set<IntOrString, IntOrStringComparator> weirdSet{x, y};
     console::log(weirdSet);
 
+    // Flat hash set: looked up with a std::string_view into a parsed buffer, no IntOrString (or std::string) is built
+    const flat::IntOrStringSet flatSet{x, y, 42, "forty-two"};
+    const std::string_view parsed = std::string_view("key=forty-two").substr(4);
+    console::log("Flat set has \"", parsed, "\": ", flatSet.contains(parsed), ", 42: ", flatSet.contains(42), ", 43: ", flatSet.contains(43));
+
+    // Sorted flat set built in one shot: ints and strings in separate sorted arrays, same order as weirdSet
+    const auto sortedSet = flat::SortedIntOrStringSet::fromUnsorted(std::vector<IntOrString>{"b", 3, y, 1, "a", x, 2});
+    std::cout << "Sorted flat set:";
+    // Tagged like IntOrString, so the string "1" isn't mistaken for the int 1
+    sortedSet.forEach([](const auto& key) {
+        std::cout << (std::same_as<std::remove_cvref_t<decltype(key)>, int> ? " i_" : " s_") << key;
+    });
+    console::log("; has \"a\": ", sortedSet.contains("a"), ", 4: ", sortedSet.contains(4));
+
+    // Many threads logging at once: whole lines, no interleaving, no waiting for the output
+    std::vector<std::jthread> workers;
+    for (int worker = 0; worker < 4; ++worker) {
+        workers.emplace_back([worker] {
+            for (int i = 0; i < 3; ++i) console::logAsync("Worker ", worker, ": ", Ink{"cyan"}, ", step ", i);
+        });
+    }
+    workers.clear();
+    // Wait for the background thread before mixing with synchronous output again
+    asyncLogger().flush();
+    console::log("Async records written");
+
+    // Binary log: only the call site ID and the argument bytes are written, text is rendered by the decoder
+    const std::filesystem::path binaryLog = std::filesystem::temp_directory_path() / "concepts.binlog";
+    {
+        binlog::Writer writer(binaryLog);
+        for (int i = 0; i < 3; ++i) {
+            binlog::log<"Event {}: x = {}, y = {}, ratio {}">(writer, i, x, y, 1.0 / (i + 1));
+        }
+        binlog::log<"Ink {}">(writer, Ink{"black"}); // not a plain type: formatted to text at the call
+        writer.close();
+    }
+    const MappedFile binaryLogFile(binaryLog);
+    console::log("Binary log, ", binaryLogFile.size(), " bytes, decoded:");
+    binlog::decode(binaryLogFile, std::cout);
+
     return 0;
 }
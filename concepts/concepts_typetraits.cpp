@@ -1,10 +1,17 @@
 #include <concepts>
+#include <format>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <set>
 #include <type_traits>
 
+#include "async_log.hpp"
+#include "intern.hpp"
+
 
 // Specialize templates to identify std::set and std::unordered_set
 // Must be declared before the first use.
@@ -51,25 +58,61 @@ concept Printable = requires(std::ostream& os, const T& obj) {
 };
 
 namespace console {
+    // Formatted straight into the buffer when possible, with operator<< otherwise.
+    // Containers are handled here, element by element, like operator<< above:
+    // C++23 std::format would print them as {"UP", "DOWN"}.
+    template<Printable T>
+    void append(std::string& buffer, const T& obj) {
+        if constexpr (PrintableContainer<T>) {
+            bool isFirst = true;
+            for (const auto& item : obj) {
+                if (!isFirst) buffer += ", ";
+                append(buffer, item);
+                isFirst = false;
+            }
+        } else if constexpr (std::formattable<T, char>) {
+            std::format_to(std::back_inserter(buffer), "{}", obj);
+        } else {
+            thread_local std::ostringstream stream;
+            stream.str({});
+            stream << obj;
+            buffer += stream.view();
+        }
+    }
+
     // Log function template using the Printable concept.
+    // The line is built in a reused per-thread buffer and written at once.
     template<Printable... Args>
     void log(const Args&... objs) {
-        (std::cout << ... << objs) << std::endl;
+        thread_local std::string buffer;
+        buffer.clear();
+        (append(buffer, objs), ...);
+        buffer += '\n';
+        std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size())).flush();
+    }
+
+    // Asynchronous version, see async_log.hpp: formatting and writing happen on a background thread
+    template<Printable... Args>
+    void logAsync(const Args&... objs) {
+        asyncLogger().log([](std::ostream& out, const auto&... values) { (out << ... << values); }, objs...);
     }
 }
 
 
 
 // Custom Printable class compatible with set and unordered_set containers
+// The color is an interned symbol (see intern.hpp): 4 bytes per Ink instead of a std::string,
+// equality and hashing don't look at the characters.
 class Ink {
 private:
-    std::string color;
+    intern::Symbol color;
 public:
-    explicit Ink(std::string color) : color(std::move(color)) {}
+    explicit Ink(std::string_view color) : color(color) {}
 
     // Add comparison operator for std::set compatibility
+    // Alphabetical, by the characters: symbols order by interning order, which depends on the run
     bool operator<(const Ink& other) const {
-        return color < other.color;
+        return color != other.color && color.view() < other.color.view();
     }
     // Optional: Add equality operator for completeness
     bool operator==(const Ink& other) const {
@@ -77,8 +120,8 @@ public:
     }
 
     // Getter for accessing color (needed for hash function)
-    const std::string& getColor() const {
-        return color;
+    std::string_view getColor() const {
+        return color.view();
     }
 
     // Printable friend: the non-member function operator<< will have access to private members
@@ -101,8 +144,18 @@ std::ostream& operator<<(std::ostream& out, const Ink& ink)
 template<>
 struct std::hash<Ink> {
     std::size_t operator()(const Ink& ink) const noexcept {
-        // Use the hash of the color string
-        return std::hash<std::string>{}(ink.color);
+        // Use the hash of the color symbol: an integer, the string isn't read
+        return std::hash<intern::Symbol>{}(ink.color);
+    }
+};
+
+// Specialize std::formatter for Ink: console::log formats it without going through std::ostream
+template<>
+struct std::formatter<Ink> {
+    constexpr auto parse(std::format_parse_context& context) { return context.begin(); }
+
+    auto format(const Ink& ink, std::format_context& context) const {
+        return std::format_to(context.out(), "Ink {{ color: {} }}", ink.getColor());
     }
 };
 
@@ -122,6 +175,12 @@ int main() {
     // Set of custom Printables
     const std::unordered_set<Ink> inks = {Ink{"khorne"}, Ink{"yellow"}, Ink{"magenta"}, Ink{"cyan"}};
     console::log("Set of Printable Inks: ", inks);
+    // Alphabetical whatever the interning order
+    console::log("Ordered set of Inks: ", std::set<Ink>(inks.begin(), inks.end()));
+
+    // The set is copied for the background thread, this call doesn't format or write anything
+    console::logAsync("Set of Printable Inks, async: ", inks);
+    asyncLogger().flush();
 
     // Expected failure: Try to log a set of non-Printable items:
     // struct NonPrintable {};
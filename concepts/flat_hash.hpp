@@ -0,0 +1,697 @@
+/**
+ * flat_hash
+ *
+ * Open-addressing hash set and map (SwissTable layout) with IntOrString support:
+ *
+ *  - elements live in one flat array, no node per element; a parallel array of control bytes holds 7 bits of
+ *    each hash, and 16 of them are compared at once with SSE2 during a probe
+ *  - the full hash is cached next to each element: a string is only compared when all 64 bits match,
+ *    and growing never rehashes the keys
+ *  - transparent lookup: a set of IntOrString is searched with an int, a std::string_view or a const char *,
+ *    no std::variant (and no std::string allocation) is constructed for the lookup
+ *  - IntOrStringHash is wyhash-style (64x64 -> 128 bit multiply folding): stronger and faster than
+ *    std::hash<std::string>, and the int hash doesn't put consecutive keys into consecutive buckets
+ *
+ * Iterators and references are invalidated by any insertion that grows the table (like std::vector).
+ * Maps expose elements like C++23 std::flat_map: `std::pair<const Key &, Value &>`.
+ *
+ * Usage:
+ *  flat::IntOrStringSet set{1, "one"};
+ *  set.contains(std::string_view(buffer, length));
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace flat {
+
+    using IntOrString = std::variant<int, std::string>;
+
+    namespace detail {
+
+        inline constexpr std::uint64_t secret[] = {
+            0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc1ull,
+        };
+
+        // Multiply to 128 bits and fold: every input bit affects every output bit
+        [[nodiscard]] inline auto mix(const std::uint64_t a, const std::uint64_t b) -> std::uint64_t {
+            __extension__ using Wide = unsigned __int128;
+            const Wide product = static_cast<Wide>(a) * b;
+            return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+        }
+
+        [[nodiscard]] inline auto read64(const char *p) -> std::uint64_t {
+            std::uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        [[nodiscard]] inline auto read32(const char *p) -> std::uint64_t {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        // wyhash: 16 bytes per multiply, reads short strings with two overlapping loads instead of a byte loop
+        [[nodiscard]] inline auto hashBytes(const std::string_view bytes) -> std::uint64_t {
+            const char *p = bytes.data();
+            const std::size_t size = bytes.size();
+            std::uint64_t seed = secret[0] ^ size;
+            std::uint64_t a = 0;
+            std::uint64_t b = 0;
+            if (size <= 16) {
+                if (size >= 4) {
+                    const std::size_t middle = (size >> 3) << 2;
+                    a = (read32(p) << 32) | read32(p + middle);
+                    b = (read32(p + size - 4) << 32) | read32(p + size - 4 - middle);
+                } else if (size > 0) {
+                    a = (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16) |
+                        (static_cast<std::uint64_t>(static_cast<unsigned char>(p[size >> 1])) << 8) |
+                        static_cast<unsigned char>(p[size - 1]);
+                }
+            } else {
+                std::size_t left = size;
+                if (left > 48) {
+                    std::uint64_t lane1 = seed;
+                    std::uint64_t lane2 = seed;
+                    do {
+                        seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                        lane1 = mix(read64(p + 16) ^ secret[2], read64(p + 24) ^ lane1);
+                        lane2 = mix(read64(p + 32) ^ secret[3], read64(p + 40) ^ lane2);
+                        p += 48;
+                        left -= 48;
+                    } while (left > 48);
+                    seed ^= lane1 ^ lane2;
+                }
+                while (left > 16) {
+                    seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                    p += 16;
+                    left -= 16;
+                }
+                a = read64(p + left - 16);
+                b = read64(p + left - 8);
+            }
+            return mix(secret[1] ^ size, mix(a ^ secret[1], b ^ seed));
+        }
+
+        [[nodiscard]] inline auto hashInteger(const std::int64_t value) -> std::uint64_t {
+            return mix(static_cast<std::uint64_t>(value) ^ secret[2], secret[3]);
+        }
+
+        // Control byte: 0..127 full (7 bits of the hash), or one of these
+        inline constexpr std::int8_t empty = -128;
+        inline constexpr std::int8_t deleted = -2;
+
+        inline constexpr std::size_t groupSize = 16;
+
+        // 16 control bytes, probed at once
+        struct alignas(groupSize) Group {
+            std::int8_t control[groupSize];
+
+#if defined(__SSE2__)
+            [[nodiscard]] auto load() const -> __m128i { return _mm_load_si128(reinterpret_cast<const __m128i *>(control)); }
+
+            [[nodiscard]] auto match(const std::int8_t h2) const -> std::uint32_t {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(load(), _mm_set1_epi8(h2))));
+            }
+
+            [[nodiscard]] auto matchEmpty() const -> std::uint32_t { return match(empty); }
+
+            // Empty and deleted have the high bit set, full slots don't
+            [[nodiscard]] auto matchFree() const -> std::uint32_t {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(load()));
+            }
+#else
+            [[nodiscard]] auto match(const std::int8_t h2) const -> std::uint32_t {
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < groupSize; ++i) mask |= static_cast<std::uint32_t>(control[i] == h2) << i;
+                return mask;
+            }
+
+            [[nodiscard]] auto matchEmpty() const -> std::uint32_t { return match(empty); }
+
+            [[nodiscard]] auto matchFree() const -> std::uint32_t {
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < groupSize; ++i) mask |= static_cast<std::uint32_t>(control[i] < 0) << i;
+                return mask;
+            }
+#endif
+        };
+
+        // Key from a lookup key: IntOrString from a std::string_view needs an explicit std::string
+        template<typename Key, typename K>
+        [[nodiscard]] auto makeKey(K &&key) -> Key {
+            if constexpr (std::is_constructible_v<Key, K &&>) {
+                return Key(std::forward<K>(key));
+            } else {
+                return Key(std::string(std::string_view(key)));
+            }
+        }
+
+        template<typename Key, typename Value>
+        struct Slot {
+            std::uint64_t hash;
+            Key key;
+            Value value;
+
+            template<typename K, typename... Args>
+            Slot(const std::uint64_t hash, K &&key, Args &&...args) :
+                hash(hash), key(makeKey<Key>(std::forward<K>(key))), value(std::forward<Args>(args)...) {}
+        };
+
+        template<typename Key>
+        struct Slot<Key, void> {
+            std::uint64_t hash;
+            Key key;
+
+            template<typename K>
+            Slot(const std::uint64_t hash, K &&key) : hash(hash), key(makeKey<Key>(std::forward<K>(key))) {}
+        };
+
+        template<typename Hash>
+        concept Avalanching = requires { typename Hash::is_avalanching; };
+
+        template<typename Hash, typename Equal>
+        concept Transparent = requires {
+            typename Hash::is_transparent;
+            typename Equal::is_transparent;
+        };
+
+        // Arrow proxy for iterators returning a pair of references
+        template<typename Reference>
+        struct Arrow {
+            Reference reference;
+            auto operator->() -> Reference * { return &reference; }
+        };
+
+        /**
+         * The table behind HashSet (Value = void) and HashMap.
+         *
+         * Capacity is a power of 2, at least one group; at most 7/8 of the slots are used (full or deleted),
+         * so every probe sequence reaches a group with an empty slot. Groups are probed triangularly: 1, 2, 3...
+         * groups further, which visits every group of a power of 2 table.
+         */
+        template<typename Key, typename Value, typename Hash, typename Equal>
+        class Table {
+        public:
+            using SlotType = Slot<Key, Value>;
+
+            Table() = default;
+
+            Table(const Table &other) : hash_(other.hash_), equal_(other.equal_) {
+                reserve(other.size_);
+                for (std::size_t i = 0; i < other.capacity_; ++i) {
+                    if (other.control()[i] >= 0) insertNew(other.slots_[i].hash, other.slots_[i]);
+                }
+            }
+
+            Table(Table &&other) noexcept :
+                groups_(std::move(other.groups_)), slots_(std::exchange(other.slots_, nullptr)),
+                capacity_(std::exchange(other.capacity_, 0)), size_(std::exchange(other.size_, 0)),
+                growthLeft_(std::exchange(other.growthLeft_, 0)), hash_(std::move(other.hash_)), equal_(std::move(other.equal_)) {}
+
+            auto operator=(Table other) noexcept -> Table & {
+                swap(other);
+                return *this;
+            }
+
+            ~Table() { destroy(); }
+
+            void swap(Table &other) noexcept {
+                std::swap(groups_, other.groups_);
+                std::swap(slots_, other.slots_);
+                std::swap(capacity_, other.capacity_);
+                std::swap(size_, other.size_);
+                std::swap(growthLeft_, other.growthLeft_);
+                std::swap(hash_, other.hash_);
+                std::swap(equal_, other.equal_);
+            }
+
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+            [[nodiscard]] auto capacity() const noexcept -> std::size_t { return capacity_; }
+
+            // Grow so that `count` elements fit without another rehash
+            void reserve(const std::size_t count) {
+                if (count <= size_ + growthLeft_) return;
+                rehash(std::max(groupSize, std::bit_ceil(count + count / 7 + 1)));
+            }
+
+            void clear() noexcept {
+                destroySlots();
+                if (capacity_ > 0) std::memset(control(), empty, capacity_);
+                size_ = 0;
+                growthLeft_ = maxLoad(capacity_);
+            }
+
+            template<typename K>
+            [[nodiscard]] auto hashOf(const K &key) const -> std::uint64_t {
+                const auto hash = static_cast<std::uint64_t>(hash_(key));
+                if constexpr (Avalanching<Hash>) {
+                    return hash;
+                } else {
+                    // e.g. std::hash<int> is the identity: spread it before taking 7 bits for the control byte
+                    return mix(hash ^ secret[0], secret[1]);
+                }
+            }
+
+            // Slot index of `key`, or capacity() if it's not there
+            template<typename K>
+            [[nodiscard]] auto find(const K &key, const std::uint64_t hash) const -> std::size_t {
+                if (capacity_ == 0) return capacity_;
+                const auto h2 = static_cast<std::int8_t>(hash & 0x7F);
+                const std::size_t groupMask = capacity_ / groupSize - 1;
+                std::size_t group = (hash >> 7) & groupMask;
+                for (std::size_t step = 1;; ++step) {
+                    const Group &probed = groups_[group];
+                    for (std::uint32_t match = probed.match(h2); match != 0; match &= match - 1) {
+                        const std::size_t index = group * groupSize + static_cast<std::size_t>(std::countr_zero(match));
+                        if (slots_[index].hash == hash && equal_(slots_[index].key, key)) return index;
+                    }
+                    if (probed.matchEmpty() != 0) return capacity_;
+                    group = (group + step) & groupMask;
+                }
+            }
+
+            /**
+             * Find `key`, or insert a new element: Slot(hash, key, args...). Nothing is constructed if it's found.
+             *
+             * @return slot index and whether it was inserted
+             */
+            template<typename K, typename... Args>
+            auto findOrInsert(K &&key, Args &&...args) -> std::pair<std::size_t, bool> {
+                const std::uint64_t hash = hashOf(key);
+                if (const std::size_t index = find(key, hash); index != capacity_) return {index, false};
+                if (growthLeft_ == 0) grow();
+                const std::size_t index = freeSlot(hash);
+                std::construct_at(&slots_[index], hash, std::forward<K>(key), std::forward<Args>(args)...);
+                occupy(index, hash);
+                return {index, true};
+            }
+
+            void eraseAt(const std::size_t index) noexcept {
+                std::destroy_at(&slots_[index]);
+                // A probe only continues past a group without empty slots: if this group has one,
+                // no probe went through it, and the slot can become empty instead of a tombstone
+                if (groups_[index / groupSize].matchEmpty() != 0) {
+                    control()[index] = empty;
+                    ++growthLeft_;
+                } else {
+                    control()[index] = deleted;
+                }
+                --size_;
+            }
+
+            [[nodiscard]] auto control() const noexcept -> std::int8_t * { return groups_[0].control; }
+            [[nodiscard]] auto slots() const noexcept -> SlotType * { return slots_; }
+
+            // First full slot at or after `index`, capacity() if none
+            [[nodiscard]] auto nextFull(std::size_t index) const noexcept -> std::size_t {
+                while (index < capacity_ && control()[index] < 0) ++index;
+                return index;
+            }
+
+        private:
+            [[nodiscard]] static constexpr auto maxLoad(const std::size_t capacity) -> std::size_t {
+                return capacity - capacity / 8;
+            }
+
+            // First empty or deleted slot on the probe sequence of `hash`
+            [[nodiscard]] auto freeSlot(const std::uint64_t hash) const -> std::size_t {
+                const std::size_t groupMask = capacity_ / groupSize - 1;
+                std::size_t group = (hash >> 7) & groupMask;
+                for (std::size_t step = 1;; ++step) {
+                    if (const std::uint32_t free = groups_[group].matchFree(); free != 0) {
+                        return group * groupSize + static_cast<std::size_t>(std::countr_zero(free));
+                    }
+                    group = (group + step) & groupMask;
+                }
+            }
+
+            void occupy(const std::size_t index, const std::uint64_t hash) {
+                if (control()[index] == empty) --growthLeft_;
+                control()[index] = static_cast<std::int8_t>(hash & 0x7F);
+                ++size_;
+            }
+
+            // Copy of a slot from another table, hash already known
+            void insertNew(const std::uint64_t hash, const SlotType &slot) {
+                const std::size_t index = freeSlot(hash);
+                std::construct_at(&slots_[index], slot);
+                occupy(index, hash);
+            }
+
+            void grow() {
+                // Mostly tombstones: clean up in place instead of doubling
+                if (capacity_ > 0 && size_ <= maxLoad(capacity_) / 2) {
+                    rehash(capacity_);
+                } else {
+                    rehash(capacity_ == 0 ? groupSize : capacity_ * 2);
+                }
+            }
+
+            // Move everything into a new table of `capacity` slots, with the cached hashes
+            void rehash(const std::size_t capacity) {
+                std::unique_ptr<Group[]> groups = std::make_unique_for_overwrite<Group[]>(capacity / groupSize);
+                std::memset(groups[0].control, empty, capacity);
+                SlotType *slots = std::allocator<SlotType>().allocate(capacity);
+
+                std::unique_ptr<Group[]> oldGroups = std::exchange(groups_, std::move(groups));
+                SlotType *oldSlots = std::exchange(slots_, slots);
+                const std::size_t oldCapacity = std::exchange(capacity_, capacity);
+                size_ = 0;
+                growthLeft_ = maxLoad(capacity);
+
+                for (std::size_t i = 0; i < oldCapacity; ++i) {
+                    if (oldGroups[0].control[i] < 0) continue;
+                    const std::uint64_t hash = oldSlots[i].hash;
+                    const std::size_t index = freeSlot(hash);
+                    std::construct_at(&slots_[index], std::move(oldSlots[i]));
+                    std::destroy_at(&oldSlots[i]);
+                    occupy(index, hash);
+                }
+                if (oldSlots) std::allocator<SlotType>().deallocate(oldSlots, oldCapacity);
+            }
+
+            void destroySlots() noexcept {
+                if constexpr (!std::is_trivially_destructible_v<SlotType>) {
+                    for (std::size_t i = 0; i < capacity_; ++i) {
+                        if (control()[i] >= 0) std::destroy_at(&slots_[i]);
+                    }
+                }
+            }
+
+            void destroy() noexcept {
+                if (!slots_) return;
+                destroySlots();
+                std::allocator<SlotType>().deallocate(slots_, capacity_);
+                slots_ = nullptr;
+            }
+
+            std::unique_ptr<Group[]> groups_;
+            SlotType *slots_ = nullptr;
+            std::size_t capacity_ = 0;
+            std::size_t size_ = 0;
+            std::size_t growthLeft_ = 0;
+            [[no_unique_address]] Hash hash_;
+            [[no_unique_address]] Equal equal_;
+        };
+
+    }
+
+    /**
+     * Hash for IntOrString, and for int / std::string_view / const char * / std::string looking up IntOrString keys:
+     * an int and IntOrString{int} hash the same, so do a string and IntOrString{string}.
+     */
+    struct IntOrStringHash {
+        using is_transparent = void;
+        using is_avalanching = void; // all bits are good, used as they are
+
+        [[nodiscard]] auto operator()(const IntOrString &value) const noexcept -> std::uint64_t {
+            if (const int *number = std::get_if<int>(&value)) return detail::hashInteger(*number);
+            return detail::hashBytes(std::get<std::string>(value));
+        }
+
+        template<typename K> requires (!std::same_as<K, IntOrString>)
+        [[nodiscard]] auto operator()(const K &key) const noexcept -> std::uint64_t {
+            if constexpr (std::integral<K>) {
+                return detail::hashInteger(key);
+            } else {
+                return detail::hashBytes(std::string_view(key));
+            }
+        }
+    };
+
+    struct IntOrStringEqual {
+        using is_transparent = void;
+
+        template<typename K>
+        [[nodiscard]] auto operator()(const IntOrString &stored, const K &key) const noexcept -> bool {
+            if constexpr (std::same_as<K, IntOrString>) {
+                return stored == key;
+            } else if constexpr (std::integral<K>) {
+                const int *number = std::get_if<int>(&stored);
+                return number && *number == key;
+            } else {
+                const std::string *string = std::get_if<std::string>(&stored);
+                return string && *string == std::string_view(key);
+            }
+        }
+    };
+
+    template<typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+    class HashSet {
+        using Table = detail::Table<Key, void, Hash, Equal>;
+
+        // Lookup key type: anything with a transparent hash, otherwise Key itself
+        template<typename K>
+        static constexpr bool lookup = detail::Transparent<Hash, Equal> || std::same_as<K, Key>;
+
+    public:
+        using value_type = Key;
+        using size_type = std::size_t;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Key;
+            using difference_type = std::ptrdiff_t;
+            using reference = const Key &;
+            using pointer = const Key *;
+
+            iterator() = default;
+            iterator(const Table *table, const std::size_t index) : table_(table), index_(index) {}
+
+            [[nodiscard]] auto operator*() const -> const Key & { return table_->slots()[index_].key; }
+            [[nodiscard]] auto operator->() const -> const Key * { return &table_->slots()[index_].key; }
+
+            auto operator++() -> iterator & {
+                index_ = table_->nextFull(index_ + 1);
+                return *this;
+            }
+
+            auto operator++(int) -> iterator {
+                iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            [[nodiscard]] auto operator==(const iterator &other) const -> bool = default;
+
+        private:
+            friend class HashSet;
+            const Table *table_ = nullptr;
+            std::size_t index_ = 0;
+        };
+        using const_iterator = iterator;
+
+        HashSet() = default;
+
+        HashSet(const std::initializer_list<Key> keys) {
+            reserve(keys.size());
+            for (const Key &key : keys) insert(key);
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return table_.size(); }
+        [[nodiscard]] auto empty() const noexcept -> bool { return table_.size() == 0; }
+        [[nodiscard]] auto capacity() const noexcept -> std::size_t { return table_.capacity(); }
+
+        void reserve(const std::size_t count) { table_.reserve(count); }
+        void clear() noexcept { table_.clear(); }
+
+        [[nodiscard]] auto begin() const -> iterator { return {&table_, table_.nextFull(0)}; }
+        [[nodiscard]] auto end() const -> iterator { return {&table_, table_.capacity()}; }
+
+        /**
+         * Insert a key, a Key is only constructed from `key` when it's not in the set yet
+         * (with a transparent hash, e.g. a std::string_view is copied into a std::string only then).
+         *
+         * @return position of the key, and whether it was inserted
+         */
+        template<typename K = Key> requires lookup<std::remove_cvref_t<K>>
+        auto insert(K &&key) -> std::pair<iterator, bool> {
+            const auto [index, inserted] = table_.findOrInsert(std::forward<K>(key));
+            return {{&table_, index}, inserted};
+        }
+
+        template<typename K> requires lookup<K>
+        [[nodiscard]] auto find(const K &key) const -> iterator {
+            return {&table_, table_.find(key, table_.hashOf(key))};
+        }
+
+        template<typename K> requires lookup<K>
+        [[nodiscard]] auto contains(const K &key) const -> bool {
+            return table_.find(key, table_.hashOf(key)) != table_.capacity();
+        }
+
+        // const char * and string literals, with a transparent hash
+        [[nodiscard]] auto find(const char *key) const -> iterator requires detail::Transparent<Hash, Equal> {
+            return find(std::string_view(key));
+        }
+
+        [[nodiscard]] auto contains(const char *key) const -> bool requires detail::Transparent<Hash, Equal> {
+            return contains(std::string_view(key));
+        }
+
+        void erase(const iterator position) { table_.eraseAt(position.index_); }
+
+        template<typename K> requires lookup<K>
+        auto erase(const K &key) -> std::size_t {
+            const std::size_t index = table_.find(key, table_.hashOf(key));
+            if (index == table_.capacity()) return 0;
+            table_.eraseAt(index);
+            return 1;
+        }
+
+    private:
+        Table table_;
+    };
+
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+    class HashMap {
+        using Table = detail::Table<Key, Value, Hash, Equal>;
+
+        template<typename K>
+        static constexpr bool lookup = detail::Transparent<Hash, Equal> || std::same_as<K, Key>;
+
+        template<bool isConst>
+        class Iterator {
+            using TablePointer = std::conditional_t<isConst, const Table *, Table *>;
+            using ValueReference = std::conditional_t<isConst, const Value &, Value &>;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<Key, Value>;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::pair<const Key &, ValueReference>;
+
+            Iterator() = default;
+            Iterator(const TablePointer table, const std::size_t index) : table_(table), index_(index) {}
+            // iterator -> const_iterator
+            template<bool otherConst> requires (isConst && !otherConst)
+            Iterator(const Iterator<otherConst> &other) : table_(other.table_), index_(other.index_) {}
+
+            [[nodiscard]] auto operator*() const -> reference {
+                auto &slot = table_->slots()[index_];
+                return {slot.key, slot.value};
+            }
+
+            [[nodiscard]] auto operator->() const -> detail::Arrow<reference> { return {**this}; }
+
+            auto operator++() -> Iterator & {
+                index_ = table_->nextFull(index_ + 1);
+                return *this;
+            }
+
+            auto operator++(int) -> Iterator {
+                Iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            [[nodiscard]] auto operator==(const Iterator &other) const -> bool = default;
+
+        private:
+            friend class HashMap;
+            friend class Iterator<true>;
+            TablePointer table_ = nullptr;
+            std::size_t index_ = 0;
+        };
+
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using size_type = std::size_t;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return table_.size(); }
+        [[nodiscard]] auto empty() const noexcept -> bool { return table_.size() == 0; }
+
+        void reserve(const std::size_t count) { table_.reserve(count); }
+        void clear() noexcept { table_.clear(); }
+
+        [[nodiscard]] auto begin() -> iterator { return {&table_, table_.nextFull(0)}; }
+        [[nodiscard]] auto end() -> iterator { return {&table_, table_.capacity()}; }
+        [[nodiscard]] auto begin() const -> const_iterator { return {&table_, table_.nextFull(0)}; }
+        [[nodiscard]] auto end() const -> const_iterator { return {&table_, table_.capacity()}; }
+
+        /**
+         * Insert `key` with a value made from `args`, unless the key is there already (then nothing is constructed).
+         *
+         * @return position of the key, and whether it was inserted
+         */
+        template<typename K, typename... Args> requires lookup<std::remove_cvref_t<K>>
+        auto tryEmplace(K &&key, Args &&...args) -> std::pair<iterator, bool> {
+            const auto [index, inserted] = table_.findOrInsert(std::forward<K>(key), std::forward<Args>(args)...);
+            return {{&table_, index}, inserted};
+        }
+
+        template<typename K> requires lookup<std::remove_cvref_t<K>>
+        auto operator[](K &&key) -> Value & {
+            return (*tryEmplace(std::forward<K>(key)).first).second;
+        }
+
+        template<typename K> requires lookup<K>
+        [[nodiscard]] auto find(const K &key) -> iterator {
+            return {&table_, table_.find(key, table_.hashOf(key))};
+        }
+
+        template<typename K> requires lookup<K>
+        [[nodiscard]] auto find(const K &key) const -> const_iterator {
+            return {&table_, table_.find(key, table_.hashOf(key))};
+        }
+
+        template<typename K> requires lookup<K>
+        [[nodiscard]] auto contains(const K &key) const -> bool {
+            return table_.find(key, table_.hashOf(key)) != table_.capacity();
+        }
+
+        [[nodiscard]] auto find(const char *key) -> iterator requires detail::Transparent<Hash, Equal> {
+            return find(std::string_view(key));
+        }
+
+        [[nodiscard]] auto contains(const char *key) const -> bool requires detail::Transparent<Hash, Equal> {
+            return contains(std::string_view(key));
+        }
+
+        void erase(const iterator position) { table_.eraseAt(position.index_); }
+
+        template<typename K> requires lookup<K>
+        auto erase(const K &key) -> std::size_t {
+            const std::size_t index = table_.find(key, table_.hashOf(key));
+            if (index == table_.capacity()) return 0;
+            table_.eraseAt(index);
+            return 1;
+        }
+
+    private:
+        Table table_;
+    };
+
+    using IntOrStringSet = HashSet<IntOrString, IntOrStringHash, IntOrStringEqual>;
+
+    template<typename Value>
+    using IntOrStringMap = HashMap<IntOrString, Value, IntOrStringHash, IntOrStringEqual>;
+
+}
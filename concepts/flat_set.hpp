@@ -0,0 +1,183 @@
+/**
+ * flat_set
+ *
+ * Sorted, immutable set of IntOrString built in one shot from unsorted data, for build-once / query-often sets.
+ *
+ * Compared to std::set<IntOrString, IntOrStringComparator>:
+ *  - no tree node per element: ints and strings are partitioned into two sorted contiguous arrays, so sorting and
+ *    searching compare plain ints or plain strings, never branching on the variant index
+ *  - bulk construction: partition, sort (in parallel with an execution policy), dedup, instead of N tree inserts
+ *  - int lookups search an Eytzinger (BFS order) copy of the array: the first levels share a few cache lines,
+ *    each next level is prefetched, no unpredictable branches
+ *  - string lookups binary search 8-byte big-endian prefixes first, the strings themselves (heap memory) are only
+ *    compared within the run of keys with the same prefix
+ *
+ * Order is the same as IntOrStringComparator: ints first, then strings.
+ *
+ * Usage:
+ *  const auto set = flat::SortedIntOrStringSet::fromUnsorted(std::execution::par, keys);
+ *  set.contains(42); set.contains("forty-two");
+ *
+ * Include <execution> where a policy is passed. With libstdc++, parallel policies run on TBB: link with -ltbb.
+ * This header doesn't include <execution>, so programs that don't use a policy don't need TBB.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+
+namespace flat {
+
+    using IntOrString = std::variant<int, std::string>;
+
+    class SortedIntOrStringSet {
+    public:
+        SortedIntOrStringSet() = default;
+
+        /**
+         * Build from any range of IntOrString (moved from if it's an rvalue range), duplicates are removed.
+         *
+         * @param policy e.g. std::execution::par for the sorts and dedups
+         * @param keys unsorted keys
+         */
+        template<typename Policy, std::ranges::input_range Keys> requires (!std::ranges::range<Policy>)
+        [[nodiscard]] static auto fromUnsorted(Policy &&policy, Keys &&keys) -> SortedIntOrStringSet {
+            SortedIntOrStringSet set;
+            set.partition(std::forward<Keys>(keys));
+
+            std::sort(policy, set.ints_.begin(), set.ints_.end());
+            set.ints_.erase(std::unique(policy, set.ints_.begin(), set.ints_.end()), set.ints_.end());
+            std::sort(policy, set.strings_.begin(), set.strings_.end());
+            set.strings_.erase(std::unique(policy, set.strings_.begin(), set.strings_.end()), set.strings_.end());
+
+            set.index();
+            return set;
+        }
+
+        template<std::ranges::input_range Keys>
+        [[nodiscard]] static auto fromUnsorted(Keys &&keys) -> SortedIntOrStringSet {
+            SortedIntOrStringSet set;
+            set.partition(std::forward<Keys>(keys));
+
+            std::ranges::sort(set.ints_);
+            set.ints_.erase(std::ranges::unique(set.ints_).begin(), set.ints_.end());
+            std::ranges::sort(set.strings_);
+            set.strings_.erase(std::ranges::unique(set.strings_).begin(), set.strings_.end());
+
+            set.index();
+            return set;
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return ints_.size() + strings_.size(); }
+        [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+        // Sorted parts: all ints come before all strings
+        [[nodiscard]] auto ints() const noexcept -> std::span<const int> { return ints_; }
+        [[nodiscard]] auto strings() const noexcept -> std::span<const std::string> { return strings_; }
+
+        [[nodiscard]] auto contains(const int key) const noexcept -> bool {
+            const std::size_t n = ints_.size();
+            // 1-based BFS order: children of k are 2k and 2k + 1
+            std::size_t k = 1;
+            while (k <= n) {
+                // Node 16k, a descendant 4 levels down; no pointer past the end of the array is formed
+                if (k * 16 < eytzinger_.size()) __builtin_prefetch(eytzinger_.data() + k * 16);
+                k = 2 * k + static_cast<std::size_t>(eytzinger_[k] < key);
+            }
+            // Undo the right turns after the last left turn: that node is the first element >= key
+            k >>= std::countr_one(k) + 1;
+            return k != 0 && eytzinger_[k] == key;
+        }
+
+        [[nodiscard]] auto contains(const std::string_view key) const noexcept -> bool {
+            const auto [first, last] = std::ranges::equal_range(prefixes_, prefixOf(key));
+            if (first == last) return false;
+            // Usually one string has the prefix, but keys like "item-000..." can share it: search that run only
+            const auto begin = strings_.begin() + (first - prefixes_.begin());
+            const auto end = strings_.begin() + (last - prefixes_.begin());
+            const auto position = std::lower_bound(begin, end, key, std::less<>{});
+            return position != end && *position == key;
+        }
+
+        [[nodiscard]] auto contains(const char *key) const noexcept -> bool { return contains(std::string_view(key)); }
+
+        [[nodiscard]] auto contains(const IntOrString &key) const noexcept -> bool {
+            if (const int *number = std::get_if<int>(&key)) return contains(*number);
+            return contains(std::string_view(std::get<std::string>(key)));
+        }
+
+        /**
+         * Call fn(int) for each int, then fn(std::string_view) for each string, in order.
+         */
+        template<typename Fn>
+        void forEach(Fn &&fn) const {
+            for (const int number : ints_) fn(number);
+            for (const std::string &string : strings_) fn(std::string_view(string));
+        }
+
+    private:
+        template<typename Keys>
+        void partition(Keys &&keys) {
+            if constexpr (std::ranges::sized_range<Keys>) {
+                ints_.reserve(std::ranges::size(keys));
+            }
+            for (auto &&key : keys) {
+                if (const int *number = std::get_if<int>(&key)) {
+                    ints_.push_back(*number);
+                } else if constexpr (std::is_rvalue_reference_v<Keys &&> && !std::is_const_v<std::remove_reference_t<decltype(key)>>) {
+                    strings_.push_back(std::move(std::get<std::string>(key)));
+                } else {
+                    strings_.push_back(std::get<std::string>(key));
+                }
+            }
+            ints_.shrink_to_fit();
+        }
+
+        // First 8 bytes, big-endian, zero padded: ordered like the strings themselves
+        [[nodiscard]] static auto prefixOf(const std::string_view string) noexcept -> std::uint64_t {
+            unsigned char bytes[8] = {};
+            std::memcpy(bytes, string.data(), std::min<std::size_t>(string.size(), 8));
+            std::uint64_t prefix = 0;
+            for (const unsigned char byte : bytes) prefix = (prefix << 8) | byte;
+            return prefix;
+        }
+
+        // Lookup structures, after sorting
+        void index() {
+            eytzinger_.assign(ints_.size() + 1, 0);
+            std::size_t next = 0;
+            fillEytzinger(next, 1);
+
+            prefixes_.resize(strings_.size());
+            std::ranges::transform(strings_, prefixes_.begin(), [](const std::string &string) { return prefixOf(string); });
+        }
+
+        // In-order walk of the implicit tree assigns the sorted ints
+        void fillEytzinger(std::size_t &next, const std::size_t k) {
+            if (k >= eytzinger_.size()) return;
+            fillEytzinger(next, 2 * k);
+            eytzinger_[k] = ints_[next++];
+            fillEytzinger(next, 2 * k + 1);
+        }
+
+        std::vector<int> ints_;
+        std::vector<std::string> strings_;
+        std::vector<int> eytzinger_;            // ints in BFS order, 1-based
+        std::vector<std::uint64_t> prefixes_;   // per string
+    };
+
+}
@@ -0,0 +1,36 @@
+/**
+ * int_or_string
+ *
+ * IntOrString and its std::set ordering, shared by concepts.cpp and bench/flat_set_bench.cpp so that the
+ * benchmark measures the same comparator as the demo.
+ */
+
+#pragma once
+
+#include <string>
+#include <variant>
+
+
+// IntOrString typesafe union with std::variant
+using IntOrString = std::variant<int, std::string>;
+
+// Custom comparison operator for std::set compatibility
+struct IntOrStringComparator {
+    bool operator()(const IntOrString& a, const IntOrString& b) const noexcept {
+        // Define a consistent ordering for different types:
+        // - Integers come before strings.
+        // - Within the same type, use natural ordering.
+
+        if (a.index() == 0 && b.index() == 0) { // Both are int
+            return std::get<int>(a) < std::get<int>(b);
+        } else if (a.index() == 1 && b.index() == 1) { // Both are std::string
+            return std::get<std::string>(a) < std::get<std::string>(b);
+        } else if (a.index() == 0 && b.index() == 1) { // a is int, b is string
+            return true; // int comes before string
+        } else if (a.index() == 1 && b.index() == 0) { // a is string, b is int
+            return false; // string comes after int
+        }
+        // This should not be reached:
+        return false;
+    }
+};
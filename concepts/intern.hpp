@@ -0,0 +1,232 @@
+/**
+ * intern
+ *
+ * String interning: each distinct string is stored once and gets a stable 32-bit ID (a symbol). Objects that
+ * hold one of a small vocabulary of names (colors, tags, field names...) hold the 4-byte symbol instead of
+ * a std::string: equality and hashing are one integer operation, and no allocation is made per object.
+ *
+ *  - the characters live in an arena of 64 KB blocks, never moved or freed before the table: views stay valid
+ *  - lookups of known strings are lock-free: an open-addressing index of atomic 64-bit slots (32 bits of the
+ *    hash, 32 bits of the ID) and an ID -> string directory in segments that are never reallocated
+ *  - only adding a new string takes a mutex; growing the index publishes a new copy, readers still holding
+ *    the old one miss the newest strings at worst and fall back to the locked path
+ *
+ * Symbols order by ID (interning order), not alphabetically: compare view() for the alphabetical order.
+ * A symbol can be used on any thread that received it after it was interned (through a mutex, a queue...).
+ *
+ * Usage:
+ *  const intern::Symbol cyan("cyan");
+ *  cyan == intern::Symbol("cyan");   // same ID, one comparison
+ *  std::cout << cyan.view();
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "flat_hash.hpp"
+
+
+namespace intern {
+
+    class SymbolTable {
+    public:
+        // The empty string is interned first: ID 0
+        SymbolTable() : index_(new Index(initialCapacity)) { static_cast<void>(intern({})); }
+
+        ~SymbolTable() {
+            delete index_.load(std::memory_order_relaxed);
+            for (std::atomic<std::string_view *> &segment : segments_) delete[] segment.load(std::memory_order_relaxed);
+        }
+
+        SymbolTable(const SymbolTable &) = delete;
+        SymbolTable &operator=(const SymbolTable &) = delete;
+
+        /**
+         * ID of the string, added to the table on first use.
+         *
+         * @param text any bytes, copied into the table's arena
+         * @return stable ID, the same for equal strings: 0 for the empty string, then 1, 2, 3... in interning order
+         * @throws std::length_error when 2^32 - 1 strings are interned already
+         */
+        [[nodiscard]] auto intern(const std::string_view text) -> std::uint32_t {
+            const std::uint64_t hash = flat::detail::hashBytes(text);
+            if (const std::optional<std::uint32_t> id = find(text, hash)) return *id;
+
+            const std::scoped_lock lock(mutex_);
+            // Another thread may have added it since, or the lock-free lookup read an index being replaced
+            if (const std::optional<std::uint32_t> id = find(text, hash)) return *id;
+
+            const std::size_t count = size_.load(std::memory_order_relaxed);
+            if (count == maxSize) throw std::length_error("intern::SymbolTable: too many strings");
+            const auto id = static_cast<std::uint32_t>(count);
+            allocateEntry(id) = store(text);
+            size_.store(count + 1, std::memory_order_release);
+
+            Index *index = index_.load(std::memory_order_relaxed);
+            if ((count + 1) * 2 > index->mask + 1) index = grow(*index);
+            insert(*index, hash, id);
+            return id;
+        }
+
+        /**
+         * Lock-free lookup that never adds.
+         *
+         * @return ID if the string was interned, std::nullopt otherwise
+         */
+        [[nodiscard]] auto find(const std::string_view text) const -> std::optional<std::uint32_t> {
+            return find(text, flat::detail::hashBytes(text));
+        }
+
+        /**
+         * @param id returned by intern() or find() of this table
+         * @return the interned string, valid as long as the table
+         */
+        [[nodiscard]] auto view(const std::uint32_t id) const noexcept -> std::string_view {
+            const auto [segment, offset] = position(id);
+            return segments_[segment].load(std::memory_order_acquire)[offset];
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return size_.load(std::memory_order_acquire); }
+
+    private:
+        static constexpr std::size_t initialCapacity = 1024;   // index slots, a power of 2
+        static constexpr std::size_t maxSize = 0xFFFF'FFFF;    // ID + 1 has to fit into 32 bits of a slot
+        static constexpr std::size_t blockSize = 64 * 1024;    // arena
+        static constexpr unsigned firstSegmentBits = 8;        // segment s holds 256 << s directory entries
+        static constexpr std::size_t segmentCount = 33 - firstSegmentBits;
+
+        // Slot: 0 if empty, else high 32 bits of the hash and ID + 1
+        struct Index {
+            explicit Index(const std::size_t capacity) :
+                mask(capacity - 1), slots(std::make_unique<std::atomic<std::uint64_t>[]>(capacity)) {}
+
+            std::size_t mask;
+            std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+        };
+
+        [[nodiscard]] auto find(const std::string_view text, const std::uint64_t hash) const -> std::optional<std::uint32_t> {
+            const Index &index = *index_.load(std::memory_order_acquire);
+            const std::uint64_t tag = hash >> 32;
+            for (std::size_t i = hash & index.mask;; i = (i + 1) & index.mask) {
+                const std::uint64_t slot = index.slots[i].load(std::memory_order_acquire);
+                if (slot == 0) return std::nullopt;
+                if (slot >> 32 == tag) {
+                    const auto id = static_cast<std::uint32_t>(slot - 1);
+                    if (view(id) == text) return id;
+                }
+            }
+        }
+
+        static void insert(Index &index, const std::uint64_t hash, const std::uint32_t id) {
+            std::size_t i = hash & index.mask;
+            while (index.slots[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & index.mask;
+            // Release: a reader that sees the slot also sees the directory entry and the characters
+            index.slots[i].store((hash >> 32 << 32) | (std::uint64_t{id} + 1), std::memory_order_release);
+        }
+
+        // Under the mutex. The old index stays alive for readers that loaded it before the switch.
+        auto grow(const Index &old) -> Index * {
+            auto index = std::make_unique<Index>(2 * (old.mask + 1));
+            const std::size_t count = size_.load(std::memory_order_relaxed);
+            for (std::uint32_t id = 0; id + 1 < count; ++id) insert(*index, flat::detail::hashBytes(view(id)), id);
+            retired_.emplace_back(index_.exchange(index.get(), std::memory_order_acq_rel));
+            return index.release();
+        }
+
+        // Directory segment and offset of an ID: segments double in size, so they are never reallocated
+        [[nodiscard]] static auto position(const std::uint32_t id) noexcept -> std::pair<unsigned, std::size_t> {
+            const std::uint64_t n = std::uint64_t{id} + (std::uint64_t{1} << firstSegmentBits);
+            const auto segment = static_cast<unsigned>(std::bit_width(n)) - 1 - firstSegmentBits;
+            return {segment, n - (std::uint64_t{1} << (segment + firstSegmentBits))};
+        }
+
+        // Under the mutex
+        auto allocateEntry(const std::uint32_t id) -> std::string_view & {
+            const auto [segment, offset] = position(id);
+            std::string_view *entries = segments_[segment].load(std::memory_order_relaxed);
+            if (entries == nullptr) {
+                entries = new std::string_view[std::size_t{1} << (segment + firstSegmentBits)];
+                segments_[segment].store(entries, std::memory_order_release);
+            }
+            return entries[offset];
+        }
+
+        // Under the mutex: copy into the current arena block, or a block of its own for long strings
+        auto store(const std::string_view text) -> std::string_view {
+            if (text.empty()) return {};
+            if (text.size() > blockSize / 4) {
+                blocks_.push_back(std::make_unique<char[]>(text.size()));
+                std::memcpy(blocks_.back().get(), text.data(), text.size());
+                return {blocks_.back().get(), text.size()};
+            }
+            if (text.size() > blockSize - used_) {
+                blocks_.push_back(std::make_unique<char[]>(blockSize));
+                current_ = blocks_.back().get();
+                used_ = 0;
+            }
+            char *copy = current_ + used_;
+            std::memcpy(copy, text.data(), text.size());
+            used_ += text.size();
+            return {copy, text.size()};
+        }
+
+        std::atomic<Index *> index_;
+        std::array<std::atomic<std::string_view *>, segmentCount> segments_{};
+        std::atomic<std::size_t> size_{0};
+
+        // Writers only
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<Index>> retired_;
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char *current_ = nullptr;
+        std::size_t used_ = blockSize;
+    };
+
+    // Table of all Symbols, the default Symbol is the empty string (ID 0)
+    [[nodiscard]] inline auto symbols() -> SymbolTable & {
+        static SymbolTable table;
+        return table;
+    }
+
+    class Symbol {
+    public:
+        Symbol() = default;
+
+        explicit Symbol(const std::string_view text) : id_(symbols().intern(text)) {}
+
+        [[nodiscard]] auto id() const noexcept -> std::uint32_t { return id_; }
+        [[nodiscard]] auto view() const noexcept -> std::string_view { return symbols().view(id_); }
+
+        friend auto operator==(Symbol, Symbol) noexcept -> bool = default;
+        friend auto operator<=>(Symbol, Symbol) noexcept -> std::strong_ordering = default;
+
+        friend auto operator<<(std::ostream &out, const Symbol symbol) -> std::ostream & { return out << symbol.view(); }
+
+    private:
+        std::uint32_t id_ = 0;
+    };
+
+}
+
+template<>
+struct std::hash<intern::Symbol> {
+    std::size_t operator()(const intern::Symbol symbol) const noexcept {
+        return std::hash<std::uint32_t>{}(symbol.id());
+    }
+};
@@ -2,6 +2,8 @@
 #include <vector>
 #include <iostream>
 
+#include "span_print.hpp"
+
 void print_span(const std::span<int> s) {
     for (const int x : s) {
         std::cout << x << " ";
@@ -23,5 +25,12 @@ int main() {
     const std::span subspan(span.data() + 1, 3); // View of {2, 3, 4}
     print_span(subspan); // 2 3 4
 
+    // Large spans: one buffer, digit pairs / std::to_chars, one write per 64K elements (see span_print.hpp)
+    std::cout.flush();
+    spans::print(subspan); // 2 3 4
+    spans::print(span, {.separator = ", ", .notation = spans::Notation::hex}); // 1, 2, 3, 4, 5
+    const std::vector<double> ratios = {0.5, 1.0 / 3, 2.0};
+    spans::print(ratios, {.notation = spans::Notation::fixed, .precision = 2}); // 0.50 0.33 2.00
+
     return 0;
-}
\ No newline at end of file
+}
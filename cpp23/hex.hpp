@@ -0,0 +1,352 @@
+/**
+ * hex
+ *
+ * Hex encoding and validating decoding of byte ranges, straight into a pre-sized output: no string per byte,
+ * no views::join, one allocation (or none, with a caller buffer).
+ *
+ * Kernels (runtime dispatch, see basics/simd.hpp):
+ *  - encode, AVX2: 32 bytes -> 64 digits per step, nibbles split with shift + and, interleaved with unpack,
+ *    mapped to digits with one vpshufb from a 16-entry table
+ *  - encode, SSE2: 16 bytes per step, digit = nibble + '0' (+ 7 or 39 for nibbles > 9)
+ *  - decode, AVX2 / SSE2: 64 / 32 digits per step, range compares for 0-9, a-f and A-F validate every digit,
+ *    then pairs of nibbles are merged (vpmaddubsw with AVX2) and packed into bytes
+ *  - scalar: 256-entry tables of digit pairs and of nibble values
+ *
+ * Integral ranges with elements wider than a byte are encoded element by element, big-endian, with
+ * 2 * sizeof(T) digits each: {0xCAFE, 0x1} as uint16_t is "cafe0001".
+ *
+ * Usage:
+ *  hex::encode(std::as_bytes(std::span(digest)));                 // "9f86d081..."
+ *  std::format("{:X}", hex::view(digest));                        // "9F86D081..."
+ *  const std::vector<std::byte> bytes = hex::decode("cafe");      // throws std::invalid_argument if not hex
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "../basics/simd.hpp"
+
+
+namespace hex {
+
+    enum class Case : std::uint8_t {
+        lower,
+        upper,
+    };
+
+    namespace detail {
+
+        // Two digits per byte value
+        template<Case letters>
+        inline constexpr auto digitPairs = [] {
+            constexpr std::string_view digits = letters == Case::lower ? "0123456789abcdef" : "0123456789ABCDEF";
+            std::array<char, 512> pairs{};
+            for (std::size_t i = 0; i < 256; ++i) {
+                pairs[2 * i] = digits[i >> 4];
+                pairs[2 * i + 1] = digits[i & 0xF];
+            }
+            return pairs;
+        }();
+
+        // Nibble value of a digit, or 0xFF
+        inline constexpr auto nibbles = [] {
+            std::array<std::uint8_t, 256> values{};
+            values.fill(0xFF);
+            for (std::size_t i = 0; i < 10; ++i) values['0' + i] = static_cast<std::uint8_t>(i);
+            for (std::size_t i = 0; i < 6; ++i) {
+                values['a' + i] = static_cast<std::uint8_t>(10 + i);
+                values['A' + i] = static_cast<std::uint8_t>(10 + i);
+            }
+            return values;
+        }();
+
+        inline void encodeScalar(const unsigned char *src, const std::size_t size, char *dst, const Case letters) {
+            const char *pairs = letters == Case::lower ? digitPairs<Case::lower>.data() : digitPairs<Case::upper>.data();
+            for (std::size_t i = 0; i < size; ++i) std::memcpy(dst + 2 * i, pairs + 2 * src[i], 2);
+        }
+
+        // Bytes decoded before the first invalid digit (2 * the result is its offset, or the next pair)
+        inline auto decodeScalar(const char *src, const std::size_t size, unsigned char *dst) -> std::size_t {
+            for (std::size_t i = 0; i < size; ++i) {
+                const std::uint8_t high = nibbles[static_cast<unsigned char>(src[2 * i])];
+                const std::uint8_t low = nibbles[static_cast<unsigned char>(src[2 * i + 1])];
+                if ((high | low) > 0xF) return i;
+                dst[i] = static_cast<unsigned char>(high << 4 | low);
+            }
+            return size;
+        }
+
+#if defined(GOTCHAS_HAS_SIMD)
+
+        GOTCHAS_TARGET("sse2")
+        inline auto digitsSSE2(const __m128i nibbles, const Case letters) -> __m128i {
+            const __m128i isLetter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+            const __m128i letterOffset = _mm_set1_epi8(letters == Case::lower ? 'a' - '0' - 10 : 'A' - '0' - 10);
+            return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), _mm_and_si128(isLetter, letterOffset));
+        }
+
+        GOTCHAS_TARGET("sse2")
+        inline auto encodeSSE2(const unsigned char *src, const std::size_t size, char *dst, const Case letters) -> std::size_t {
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+                const __m128i low = _mm_and_si128(bytes, _mm_set1_epi8(0x0F));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i), digitsSSE2(_mm_unpacklo_epi8(high, low), letters));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i + 16), digitsSSE2(_mm_unpackhi_epi8(high, low), letters));
+            }
+            return i;
+        }
+
+        GOTCHAS_TARGET("avx2")
+        inline auto encodeAVX2(const unsigned char *src, const std::size_t size, char *dst, const Case letters) -> std::size_t {
+            const __m256i table = letters == Case::lower
+                ? _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                   '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f')
+                : _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+                                   '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+            const __m256i mask = _mm256_set1_epi8(0x0F);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                const __m256i high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask);
+                const __m256i low = _mm256_and_si256(bytes, mask);
+                // Per 128-bit lane: digits of bytes 0-7 (16-23) and 8-15 (24-31)
+                const __m256i first = _mm256_shuffle_epi8(table, _mm256_unpacklo_epi8(high, low));
+                const __m256i second = _mm256_shuffle_epi8(table, _mm256_unpackhi_epi8(high, low));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+            }
+            return i + encodeSSE2(src + i, size - i, dst + 2 * i, letters);
+        }
+
+        // Nibble values of 16 digits, `valid` gets 0xFF for each hex digit
+        GOTCHAS_TARGET("sse2")
+        inline auto nibblesSSE2(const __m128i digits, __m128i &valid) -> __m128i {
+            // c - first < count, unsigned, as a signed compare after shifting by 0x80 (see ascii.hpp)
+            const __m128i digit = _mm_sub_epi8(digits, _mm_set1_epi8('0'));
+            const __m128i isDigit = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 10), _mm_add_epi8(digit, _mm_set1_epi8(-128)));
+            const __m128i letter = _mm_sub_epi8(_mm_or_si128(digits, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            const __m128i isLetter = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 6), _mm_add_epi8(letter, _mm_set1_epi8(-128)));
+            valid = _mm_or_si128(isDigit, isLetter);
+            return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                                _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+        }
+
+        GOTCHAS_TARGET("sse2")
+        inline auto decodeSSE2(const char *src, const std::size_t size, unsigned char *dst) -> std::size_t {
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                __m128i valid1;
+                __m128i valid2;
+                const __m128i first = nibblesSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i)), valid1);
+                const __m128i second = nibblesSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i + 16)), valid2);
+                if (_mm_movemask_epi8(_mm_and_si128(valid1, valid2)) != 0xFFFF) break;
+                // 16-bit lanes hold (high, low) pairs: (lane & 0xFF) << 4 | lane >> 8
+                const __m128i merged1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, _mm_set1_epi16(0xFF)), 4), _mm_srli_epi16(first, 8));
+                const __m128i merged2 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(second, _mm_set1_epi16(0xFF)), 4), _mm_srli_epi16(second, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(merged1, merged2));
+            }
+            return i;
+        }
+
+        GOTCHAS_TARGET("avx2")
+        inline auto nibblesAVX2(const __m256i digits, __m256i &valid) -> __m256i {
+            const __m256i digit = _mm256_sub_epi8(digits, _mm256_set1_epi8('0'));
+            const __m256i isDigit = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 10), _mm256_add_epi8(digit, _mm256_set1_epi8(-128)));
+            const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(digits, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            const __m256i isLetter = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 6), _mm256_add_epi8(letter, _mm256_set1_epi8(-128)));
+            valid = _mm256_or_si256(isDigit, isLetter);
+            return _mm256_or_si256(_mm256_and_si256(isDigit, digit),
+                                   _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+        }
+
+        GOTCHAS_TARGET("avx2")
+        inline auto decodeAVX2(const char *src, const std::size_t size, unsigned char *dst) -> std::size_t {
+            // high * 16 + low for each pair of bytes
+            const __m256i weights = _mm256_set1_epi16(0x0110);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                __m256i valid1;
+                __m256i valid2;
+                const __m256i first = nibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * i)), valid1);
+                const __m256i second = nibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * i + 32)), valid2);
+                if (_mm256_movemask_epi8(_mm256_and_si256(valid1, valid2)) != -1) break;
+                // packus works per 128-bit lane: restore the order of the 64-bit quarters
+                const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights), _mm256_maddubs_epi16(second, weights));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+            }
+            return i + decodeSSE2(src + 2 * i, size - i, dst + i);
+        }
+
+#endif
+
+        // Element bytes, most significant first
+        template<std::integral T>
+        inline void bigEndian(const T value, unsigned char *out) {
+            auto bits = static_cast<std::make_unsigned_t<T>>(value);
+            for (std::size_t i = sizeof(T); i-- > 0;) {
+                out[i] = static_cast<unsigned char>(bits & 0xFF);
+                if constexpr (sizeof(T) > 1) bits >>= 8;
+            }
+        }
+
+    }
+
+    [[nodiscard]] constexpr auto encodedSize(const std::size_t bytes) noexcept -> std::size_t { return 2 * bytes; }
+    [[nodiscard]] constexpr auto decodedSize(const std::size_t digits) noexcept -> std::size_t { return digits / 2; }
+
+    /**
+     * Write 2 * bytes.size() digits to `out`, no terminator.
+     *
+     * @return end of the digits
+     */
+    inline auto encode(const std::span<const std::byte> bytes, char *out, const Case letters = Case::lower) noexcept -> char * {
+        const auto *src = reinterpret_cast<const unsigned char *>(bytes.data());
+        std::size_t done = 0;
+#if defined(GOTCHAS_HAS_SIMD)
+        switch (simd::level()) {
+            case simd::Level::avx2: done = detail::encodeAVX2(src, bytes.size(), out, letters); break;
+            case simd::Level::sse2: done = detail::encodeSSE2(src, bytes.size(), out, letters); break;
+            default: break;
+        }
+#endif
+        detail::encodeScalar(src + done, bytes.size() - done, out + 2 * done, letters);
+        return out + encodedSize(bytes.size());
+    }
+
+    [[nodiscard]] inline auto encode(const std::span<const std::byte> bytes, const Case letters = Case::lower) -> std::string {
+        std::string result;
+        result.resize_and_overwrite(encodedSize(bytes.size()), [&](char *data, std::size_t) {
+            return static_cast<std::size_t>(encode(bytes, data, letters) - data);
+        });
+        return result;
+    }
+
+    /**
+     * Encode integers, each as 2 * sizeof(T) digits, most significant first (a std::string is encoded byte by byte).
+     */
+    template<std::ranges::contiguous_range Range> requires std::integral<std::ranges::range_value_t<Range>>
+    [[nodiscard]] auto encode(const Range &values, const Case letters = Case::lower) -> std::string {
+        using T = std::ranges::range_value_t<Range>;
+        const std::span<const T> elements(std::ranges::data(values), std::ranges::size(values));
+        if constexpr (sizeof(T) == 1) {
+            return encode(std::as_bytes(elements), letters);
+        } else {
+            std::string result;
+            result.resize_and_overwrite(encodedSize(elements.size_bytes()), [&](char *data, std::size_t) {
+                // Big-endian copies, a block at a time, then the byte kernel
+                std::array<unsigned char, 4096> block;
+                constexpr std::size_t perBlock = block.size() / sizeof(T);
+                char *out = data;
+                for (std::size_t first = 0; first < elements.size(); first += perBlock) {
+                    const std::size_t count = std::min(perBlock, elements.size() - first);
+                    for (std::size_t i = 0; i < count; ++i) detail::bigEndian(elements[first + i], block.data() + i * sizeof(T));
+                    out = encode(std::as_bytes(std::span(block).first(count * sizeof(T))), out, letters);
+                }
+                return static_cast<std::size_t>(out - data);
+            });
+            return result;
+        }
+    }
+
+    /**
+     * Decode digits (either case) into `out`, which must hold decodedSize(digits.size()) bytes.
+     * Stops at the first character that isn't a hex digit; bytes before it are written.
+     *
+     * @return like std::from_chars: ptr past the digits and no error, or ptr at the offending character
+     *         (or the odd last digit) and std::errc::invalid_argument
+     */
+    inline auto decode(const std::string_view digits, std::byte *out) noexcept -> std::from_chars_result {
+        auto *dst = reinterpret_cast<unsigned char *>(out);
+        const std::size_t size = decodedSize(digits.size());
+        std::size_t done = 0;
+#if defined(GOTCHAS_HAS_SIMD)
+        switch (simd::level()) {
+            case simd::Level::avx2: done = detail::decodeAVX2(digits.data(), size, dst); break;
+            case simd::Level::sse2: done = detail::decodeSSE2(digits.data(), size, dst); break;
+            default: break;
+        }
+#endif
+        // The scalar loop also finishes a SIMD block that had an invalid digit
+        done += detail::decodeScalar(digits.data() + 2 * done, size - done, dst + done);
+        if (done < size) {
+            const char *pair = digits.data() + 2 * done;
+            const bool highValid = detail::nibbles[static_cast<unsigned char>(pair[0])] != 0xFF;
+            return {pair + (highValid ? 1 : 0), std::errc::invalid_argument};
+        }
+        if (digits.size() % 2 != 0) return {digits.data() + digits.size() - 1, std::errc::invalid_argument};
+        return {digits.data() + digits.size(), std::errc{}};
+    }
+
+    /**
+     * @throws std::invalid_argument with the offset of the first character that isn't a hex digit,
+     *         or for an odd number of digits
+     */
+    [[nodiscard]] inline auto decode(const std::string_view digits) -> std::vector<std::byte> {
+        std::vector<std::byte> bytes(decodedSize(digits.size()));
+        const auto [end, error] = decode(digits, bytes.data());
+        if (error != std::errc{}) {
+            throw std::invalid_argument(std::format("hex::decode: {} at offset {}",
+                digits.size() % 2 != 0 && end == digits.data() + digits.size() - 1 ? "odd number of digits" : "not a hex digit",
+                end - digits.data()));
+        }
+        return bytes;
+    }
+
+    // Bytes to format with std::format("{}" or "{:X}", hex::view(bytes))
+    struct View {
+        std::span<const std::byte> bytes;
+    };
+
+    template<std::ranges::contiguous_range Range> requires (sizeof(std::ranges::range_value_t<Range>) == 1)
+    [[nodiscard]] auto view(const Range &bytes) noexcept -> View {
+        return {std::as_bytes(std::span(std::ranges::data(bytes), std::ranges::size(bytes)))};
+    }
+
+}
+
+// "{}" or "{:x}": lowercase digits, "{:X}": uppercase
+template<>
+struct std::formatter<hex::View> {
+    hex::Case letters = hex::Case::lower;
+
+    constexpr auto parse(std::format_parse_context &context) {
+        auto it = context.begin();
+        if (it != context.end() && (*it == 'x' || *it == 'X')) {
+            letters = *it == 'X' ? hex::Case::upper : hex::Case::lower;
+            ++it;
+        }
+        if (it != context.end() && *it != '}') throw std::format_error("hex::View: expected {}, {:x} or {:X}");
+        return it;
+    }
+
+    auto format(const hex::View &view, std::format_context &context) const {
+        // Encoded on the stack, a block at a time
+        std::array<char, 1024> digits;
+        auto out = context.out();
+        for (std::size_t first = 0; first < view.bytes.size(); first += digits.size() / 2) {
+            const auto block = view.bytes.subspan(first, std::min(digits.size() / 2, view.bytes.size() - first));
+            const char *end = hex::encode(block, digits.data(), letters);
+            // A string_view goes to the output in bulk, not character by character
+            out = std::format_to(out, "{}", std::string_view(digits.data(), end));
+        }
+        return out;
+    }
+};
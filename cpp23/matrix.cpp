@@ -0,0 +1,50 @@
+/**
+ * matrix
+ *
+ * Multidimensional subscript and std::mdspan views over linalg::Matrix, see matrix.hpp
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <mdspan>
+
+#include "matrix.hpp"
+
+// g++ -std=c++23 -O2 matrix.cpp -o /tmp/matrix && /tmp/matrix
+int main() {
+
+    linalg::Matrix<double> a(2, 3);
+    linalg::Matrix<double> b(3, 2);
+    for (std::size_t i = 0; i < 2; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            a[i, j] = static_cast<double>(i * 3 + j + 1);
+            b[j, i] = static_cast<double>(j * 2 + i + 1);
+        }
+    }
+
+    // [1 2 3; 4 5 6] * [1 2; 3 4; 5 6] = [22 28; 49 64]
+    const auto c = a * b;
+    std::cout << c[0, 0] << ' ' << c[0, 1] << ' ' << c[1, 0] << ' ' << c[1, 1] << '\n';
+
+
+    // Same element access whatever the layout, the mapping computes the offset
+    linalg::Matrix<double, std::layout_left> columns(2, 3);
+    linalg::Matrix<double, linalg::TiledLayout<64>> tiles(100, 100);
+    columns[1, 2] = 6.0;
+    tiles[70, 3] = 7.0;
+    // 5 7: column-major offset 1 + 2 * 2; 2 tiles per row of tiles, so tile (1, 0) is the third one, then row 6 column 3
+    std::cout << columns.view().mapping()(1, 2) << ' ' << tiles.data()[2 * 64 * 64 + 6 * 64 + 3] << '\n';
+
+
+    // A non-owning view, e.g. over a C array
+    double raw[6] = {1, 2, 3, 4, 5, 6};
+    std::mdspan view(raw, 2, 3);
+    // 6
+    std::cout << view[1, 2] << '\n';
+
+    // 3 x 2
+    const auto t = linalg::transpose(a);
+    std::cout << t.rows() << " x " << t.cols() << '\n';
+
+    return 0;
+}
@@ -0,0 +1,382 @@
+/**
+ * matrix
+ *
+ * Owning dense matrix on top of std::mdspan, with cache-blocked transpose and multiply.
+ *
+ * The layout is a template parameter, as for std::mdspan:
+ *  - std::layout_right: row-major, data[i * cols + j]
+ *  - std::layout_left: column-major, data[i + j * rows]
+ *  - linalg::TiledLayout<64>: 64 x 64 tiles stored one after the other (tiles and elements inside a tile
+ *    row-major), the matrix is padded with zeros to whole tiles. A tile is a contiguous 32 KB of doubles, so
+ *    the tile kernels never stride across rows that are far apart in memory
+ *
+ * Kernels:
+ *  - the naive i-j-k multiply reads B column-wise: one cache line per multiply-add once B is larger than the
+ *    cache. The blocked kernel loops i-k-j over 64 x 64 blocks: the innermost loop is c[j] += a * b[j] over
+ *    contiguous rows, which the compiler vectorizes (-O2 is enough with GCC 12+), and each block of B is
+ *    reused from cache for 64 rows of A
+ *  - column-major operands run the row-major kernel on the transposed problem: C^T = B^T A^T
+ *  - tiled operands multiply whole tiles with compile-time bounds
+ *  - other combinations (e.g. row-major times column-major) use the same blocking through mdspan indexing
+ *  - transpose copies 32 x 32 blocks, so both the reads and the writes stay within a few cache lines
+ *  - with options.threads > 1, blocks of rows of the result are spread over threads
+ *
+ * Usage:
+ *  linalg::Matrix<double> a(512, 512), b(512, 512);
+ *  a[1, 2] = 3.0;
+ *  const auto c = linalg::multiply(a, b, {.threads = 4});
+ *  std::mdspan view = c.view();
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <mdspan>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace linalg {
+
+    /**
+     * mdspan layout policy for rank-2 extents: TileSize x TileSize row-major tiles, in row-major order of tiles.
+     * Not exhaustive: the last tile row and column are padded.
+     */
+    template<std::size_t TileSize = 64>
+    struct TiledLayout {
+        static constexpr std::size_t tileSize = TileSize;
+
+        template<typename Extents>
+        class mapping {
+            static_assert(Extents::rank() == 2, "TiledLayout is for matrices");
+
+        public:
+            using extents_type = Extents;
+            using index_type = typename Extents::index_type;
+            using size_type = typename Extents::size_type;
+            using rank_type = typename Extents::rank_type;
+            using layout_type = TiledLayout;
+
+            constexpr mapping() noexcept = default;
+
+            constexpr mapping(const Extents &extents) noexcept :
+                extents_(extents), tileRows_(tiles(extents.extent(0))), tileColumns_(tiles(extents.extent(1))) {}
+
+            [[nodiscard]] constexpr auto extents() const noexcept -> const Extents & { return extents_; }
+            [[nodiscard]] constexpr auto tileRows() const noexcept -> index_type { return tileRows_; }
+            [[nodiscard]] constexpr auto tileColumns() const noexcept -> index_type { return tileColumns_; }
+
+            [[nodiscard]] constexpr auto required_span_size() const noexcept -> index_type {
+                return tileRows_ * tileColumns_ * TileSize * TileSize;
+            }
+
+            [[nodiscard]] constexpr auto operator()(const index_type i, const index_type j) const noexcept -> index_type {
+                const index_type tile = (i / TileSize) * tileColumns_ + j / TileSize;
+                return tile * TileSize * TileSize + (i % TileSize) * TileSize + j % TileSize;
+            }
+
+            static constexpr auto is_always_unique() noexcept -> bool { return true; }
+            static constexpr auto is_always_exhaustive() noexcept -> bool { return false; }
+            static constexpr auto is_always_strided() noexcept -> bool { return false; }
+            static constexpr auto is_unique() noexcept -> bool { return true; }
+            [[nodiscard]] constexpr auto is_exhaustive() const noexcept -> bool {
+                return extents_.extent(0) % TileSize == 0 && extents_.extent(1) % TileSize == 0;
+            }
+            static constexpr auto is_strided() noexcept -> bool { return false; }
+
+            friend constexpr auto operator==(const mapping &a, const mapping &b) noexcept -> bool {
+                return a.extents_ == b.extents_;
+            }
+
+        private:
+            [[nodiscard]] static constexpr auto tiles(const index_type size) noexcept -> index_type {
+                return (size + TileSize - 1) / TileSize;
+            }
+
+            Extents extents_{};
+            index_type tileRows_ = 0;
+            index_type tileColumns_ = 0;
+        };
+    };
+
+    template<typename Layout>
+    inline constexpr bool isTiled = false;
+    template<std::size_t TileSize>
+    inline constexpr bool isTiled<TiledLayout<TileSize>> = true;
+
+    struct Options {
+        unsigned threads = 1; // > 1: blocks of rows of the result on that many threads
+    };
+
+    using Extents = std::dextents<std::size_t, 2>;
+
+    template<typename T, typename Layout = std::layout_right>
+    class Matrix {
+    public:
+        using View = std::mdspan<T, Extents, Layout>;
+        using ConstView = std::mdspan<const T, Extents, Layout>;
+
+        Matrix() = default;
+
+        // Zero-initialized
+        Matrix(const std::size_t rows, const std::size_t cols) :
+            mapping_(Extents(rows, cols)), data_(mapping_.required_span_size()) {}
+
+        [[nodiscard]] auto rows() const noexcept -> std::size_t { return mapping_.extents().extent(0); }
+        [[nodiscard]] auto cols() const noexcept -> std::size_t { return mapping_.extents().extent(1); }
+
+        [[nodiscard]] auto operator[](const std::size_t i, const std::size_t j) noexcept -> T & { return data_[mapping_(i, j)]; }
+        [[nodiscard]] auto operator[](const std::size_t i, const std::size_t j) const noexcept -> const T & { return data_[mapping_(i, j)]; }
+
+        [[nodiscard]] auto view() noexcept -> View { return View(data_.data(), mapping_); }
+        [[nodiscard]] auto view() const noexcept -> ConstView { return ConstView(data_.data(), mapping_); }
+
+        // Storage in layout order, tile padding included
+        [[nodiscard]] auto data() noexcept -> std::span<T> { return data_; }
+        [[nodiscard]] auto data() const noexcept -> std::span<const T> { return data_; }
+
+        // Same shape and elements, whatever the padding
+        friend auto operator==(const Matrix &a, const Matrix &b) -> bool {
+            if (a.rows() != b.rows() || a.cols() != b.cols()) return false;
+            for (std::size_t i = 0; i < a.rows(); ++i) {
+                for (std::size_t j = 0; j < a.cols(); ++j) {
+                    if (a[i, j] != b[i, j]) return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        typename Layout::template mapping<Extents> mapping_;
+        std::vector<T> data_;
+    };
+
+
+    namespace detail {
+
+        inline constexpr std::size_t blockSize = 64;
+        inline constexpr std::size_t transposeBlockSize = 32;
+
+        // fn(0) ... fn(count - 1), interleaved over threads so that all of them get early and late blocks
+        inline void parallelFor(const std::size_t count, const unsigned threads, const std::function<void(std::size_t)> &fn) {
+            const std::size_t workers = std::min<std::size_t>(std::max(threads, 1u), count);
+            if (workers <= 1) {
+                for (std::size_t i = 0; i < count; ++i) fn(i);
+                return;
+            }
+            std::vector<std::jthread> pool;
+            for (std::size_t worker = 1; worker < workers; ++worker) {
+                pool.emplace_back([&fn, count, workers, worker] {
+                    for (std::size_t i = worker; i < count; i += workers) fn(i);
+                });
+            }
+            for (std::size_t i = 0; i < count; i += workers) fn(i);
+        }
+
+        /**
+         * out[0, count) += factor * in[0, count), in groups of 8 with a fixed trip count: GCC vectorizes that
+         * already at -O2, where its cheap cost model skips loops that would need a scalar epilogue.
+         * __restrict on the parameters, not on locals, so there's no runtime aliasing check either.
+         */
+        template<typename T>
+        void addScaled(T *__restrict out, const T *__restrict in, const T factor, const std::size_t count) {
+            constexpr std::size_t group = 8;
+            std::size_t j = 0;
+            for (; j + group <= count; j += group) {
+                for (std::size_t lane = 0; lane < group; ++lane) out[j + lane] += factor * in[j + lane];
+            }
+            for (; j < count; ++j) out[j] += factor * in[j];
+        }
+
+        // c (n x m) = a (n x k) * b (k x m), all row-major
+        template<typename T>
+        void multiplyRowMajor(const T *a, const T *b, T *c, const std::size_t n, const std::size_t k, const std::size_t m,
+                              const unsigned threads) {
+            parallelFor((n + blockSize - 1) / blockSize, threads, [=](const std::size_t block) {
+                const std::size_t rowEnd = std::min(n, (block + 1) * blockSize);
+                for (std::size_t i = block * blockSize; i < rowEnd; ++i) std::fill_n(c + i * m, m, T{});
+                for (std::size_t p0 = 0; p0 < k; p0 += blockSize) {
+                    const std::size_t pEnd = std::min(k, p0 + blockSize);
+                    for (std::size_t j0 = 0; j0 < m; j0 += 4 * blockSize) {
+                        const std::size_t jEnd = std::min(m, j0 + 4 * blockSize);
+                        for (std::size_t i = block * blockSize; i < rowEnd; ++i) {
+                            for (std::size_t p = p0; p < pEnd; ++p) {
+                                addScaled(c + i * m + j0, b + p * m + j0, a[i * k + p], jEnd - j0);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        template<std::size_t S, typename T>
+        void multiplyTile(const T *__restrict a, const T *__restrict b, T *__restrict c) {
+            for (std::size_t i = 0; i < S; ++i) {
+                for (std::size_t p = 0; p < S; ++p) {
+                    const T factor = a[i * S + p];
+                    for (std::size_t j = 0; j < S; ++j) c[i * S + j] += factor * b[p * S + j];
+                }
+            }
+        }
+
+        // Same as the matrices: tiles are row-major, tile (I, J) starts at (I * tileColumns + J) * S * S
+        template<std::size_t S, typename T>
+        void multiplyTiled(const T *a, const T *b, T *c, const std::size_t tileRows, const std::size_t tileInner,
+                           const std::size_t tileColumns, const unsigned threads) {
+            constexpr std::size_t tile = S * S;
+            parallelFor(tileRows, threads, [=](const std::size_t I) {
+                std::fill_n(c + I * tileColumns * tile, tileColumns * tile, T{});
+                for (std::size_t K = 0; K < tileInner; ++K) {
+                    for (std::size_t J = 0; J < tileColumns; ++J) {
+                        multiplyTile<S>(a + (I * tileInner + K) * tile, b + (K * tileColumns + J) * tile,
+                                        c + (I * tileColumns + J) * tile);
+                    }
+                }
+            });
+        }
+
+        template<typename A, typename B, typename C>
+        void multiplyGeneric(const A &a, const B &b, const C &c, const unsigned threads) {
+            using T = typename C::value_type;
+            const std::size_t n = a.extent(0);
+            const std::size_t k = a.extent(1);
+            const std::size_t m = b.extent(1);
+            parallelFor((n + blockSize - 1) / blockSize, threads, [&](const std::size_t block) {
+                const std::size_t rowEnd = std::min(n, (block + 1) * blockSize);
+                for (std::size_t i = block * blockSize; i < rowEnd; ++i) {
+                    for (std::size_t j = 0; j < m; ++j) c[i, j] = T{};
+                }
+                for (std::size_t p0 = 0; p0 < k; p0 += blockSize) {
+                    for (std::size_t j0 = 0; j0 < m; j0 += blockSize) {
+                        for (std::size_t i = block * blockSize; i < rowEnd; ++i) {
+                            for (std::size_t p = p0; p < std::min(k, p0 + blockSize); ++p) {
+                                const T factor = a[i, p];
+                                for (std::size_t j = j0; j < std::min(m, j0 + blockSize); ++j) c[i, j] += factor * b[p, j];
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        // out (cols x rows) = in (rows x cols) transposed, both row-major
+        template<typename T>
+        void transposeRowMajor(const T *in, T *out, const std::size_t rows, const std::size_t cols, const unsigned threads) {
+            constexpr std::size_t B = transposeBlockSize;
+            parallelFor((rows + B - 1) / B, threads, [=](const std::size_t block) {
+                const std::size_t rowEnd = std::min(rows, (block + 1) * B);
+                for (std::size_t j0 = 0; j0 < cols; j0 += B) {
+                    const std::size_t colEnd = std::min(cols, j0 + B);
+                    for (std::size_t i = block * B; i < rowEnd; ++i) {
+                        for (std::size_t j = j0; j < colEnd; ++j) out[j * rows + i] = in[i * cols + j];
+                    }
+                }
+            });
+        }
+
+        template<std::size_t S, typename T>
+        void transposeTiled(const T *in, T *out, const std::size_t tileRows, const std::size_t tileColumns,
+                            const unsigned threads) {
+            constexpr std::size_t tile = S * S;
+            parallelFor(tileRows, threads, [=](const std::size_t I) {
+                for (std::size_t J = 0; J < tileColumns; ++J) {
+                    const T *source = in + (I * tileColumns + J) * tile;
+                    T *target = out + (J * tileRows + I) * tile;
+                    for (std::size_t i = 0; i < S; ++i) {
+                        for (std::size_t j = 0; j < S; ++j) target[j * S + i] = source[i * S + j];
+                    }
+                }
+            });
+        }
+
+    }
+
+
+    /**
+     * c = a * b, on views of any layouts; the blocked kernels are used when all three layouts are the same.
+     *
+     * @throws std::invalid_argument if the extents don't match: a is n x k, b is k x m, c is n x m
+     */
+    template<typename TA, typename LayoutA, typename TB, typename LayoutB, typename T, typename LayoutC>
+        requires std::same_as<std::remove_const_t<TA>, T> && std::same_as<std::remove_const_t<TB>, T>
+    void multiply(const std::mdspan<TA, Extents, LayoutA> a, const std::mdspan<TB, Extents, LayoutB> b,
+                  const std::mdspan<T, Extents, LayoutC> c, const Options options = {}) {
+        const std::size_t n = a.extent(0);
+        const std::size_t k = a.extent(1);
+        const std::size_t m = b.extent(1);
+        if (b.extent(0) != k || c.extent(0) != n || c.extent(1) != m) {
+            throw std::invalid_argument("linalg::multiply: extents don't match");
+        }
+        constexpr bool sameLayout = std::is_same_v<LayoutA, LayoutB> && std::is_same_v<LayoutB, LayoutC>;
+        if constexpr (sameLayout && std::is_same_v<LayoutC, std::layout_right>) {
+            detail::multiplyRowMajor(a.data_handle(), b.data_handle(), c.data_handle(), n, k, m, options.threads);
+        } else if constexpr (sameLayout && std::is_same_v<LayoutC, std::layout_left>) {
+            detail::multiplyRowMajor(b.data_handle(), a.data_handle(), c.data_handle(), m, k, n, options.threads);
+        } else if constexpr (sameLayout && isTiled<LayoutC>) {
+            detail::multiplyTiled<LayoutC::tileSize>(a.data_handle(), b.data_handle(), c.data_handle(),
+                a.mapping().tileRows(), a.mapping().tileColumns(), b.mapping().tileColumns(), options.threads);
+        } else {
+            detail::multiplyGeneric(a, b, c, options.threads);
+        }
+    }
+
+    template<typename T, typename Layout>
+    [[nodiscard]] auto multiply(const Matrix<T, Layout> &a, const Matrix<T, Layout> &b, const Options options = {})
+        -> Matrix<T, Layout> {
+        Matrix<T, Layout> c(a.rows(), b.cols());
+        multiply(a.view(), b.view(), c.view(), options);
+        return c;
+    }
+
+    template<typename T, typename Layout>
+    [[nodiscard]] auto operator*(const Matrix<T, Layout> &a, const Matrix<T, Layout> &b) -> Matrix<T, Layout> {
+        return multiply(a, b);
+    }
+
+    /**
+     * out = in transposed.
+     *
+     * @throws std::invalid_argument if out isn't in.extent(1) x in.extent(0)
+     */
+    template<typename TIn, typename LayoutIn, typename T, typename LayoutOut>
+        requires std::same_as<std::remove_const_t<TIn>, T>
+    void transpose(const std::mdspan<TIn, Extents, LayoutIn> in, const std::mdspan<T, Extents, LayoutOut> out,
+                   const Options options = {}) {
+        const std::size_t rows = in.extent(0);
+        const std::size_t cols = in.extent(1);
+        if (out.extent(0) != cols || out.extent(1) != rows) {
+            throw std::invalid_argument("linalg::transpose: extents don't match");
+        }
+        if constexpr (std::is_same_v<LayoutIn, LayoutOut> && std::is_same_v<LayoutIn, std::layout_right>) {
+            detail::transposeRowMajor(in.data_handle(), out.data_handle(), rows, cols, options.threads);
+        } else if constexpr (std::is_same_v<LayoutIn, LayoutOut> && std::is_same_v<LayoutIn, std::layout_left>) {
+            detail::transposeRowMajor(in.data_handle(), out.data_handle(), cols, rows, options.threads);
+        } else if constexpr (std::is_same_v<LayoutIn, LayoutOut> && isTiled<LayoutIn>) {
+            detail::transposeTiled<LayoutIn::tileSize>(in.data_handle(), out.data_handle(),
+                in.mapping().tileRows(), in.mapping().tileColumns(), options.threads);
+        } else {
+            constexpr std::size_t B = detail::transposeBlockSize;
+            detail::parallelFor((rows + B - 1) / B, options.threads, [&](const std::size_t block) {
+                for (std::size_t j0 = 0; j0 < cols; j0 += B) {
+                    for (std::size_t i = block * B; i < std::min(rows, (block + 1) * B); ++i) {
+                        for (std::size_t j = j0; j < std::min(cols, j0 + B); ++j) out[j, i] = in[i, j];
+                    }
+                }
+            });
+        }
+    }
+
+    template<typename T, typename Layout>
+    [[nodiscard]] auto transpose(const Matrix<T, Layout> &in, const Options options = {}) -> Matrix<T, Layout> {
+        Matrix<T, Layout> out(in.cols(), in.rows());
+        transpose(in.view(), out.view(), options);
+        return out;
+    }
+
+}
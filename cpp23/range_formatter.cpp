@@ -12,6 +12,8 @@
 #include <ranges>
 #include <vector>
 
+#include "hex.hpp"
+
 // g++ -std=c++23 range_formatter.cpp -o /tmp/range_formatter && /tmp/range_formatter
 int main() {
 
@@ -42,5 +44,13 @@ int main() {
     std::cout << result << '\n';
 
 
+    // Hex of bytes without a std::string per element: one pass into a pre-sized string, see hex.hpp
+    const std::array<unsigned char, 2> bytes{0xCA, 0xFE};
+    // CAFE
+    std::cout << hex::encode(bytes, hex::Case::upper) << '\n';
+    // cafe
+    std::cout << std::format("{}", hex::view(bytes)) << '\n';
+
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+/**
+ * LineReader example: stream a file of any size line by line with bounded memory.
+ *
+ * Unlike rdbuf.cpp or mapped_file.cpp, the whole file is never in memory (or in the address space) at once.
+ */
+
+
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../basics/utf8.hpp"
+#include "line_reader.hpp"
+
+// g++ -std=c++23 line_reader.cpp -o /tmp/line_reader && /tmp/line_reader ../README.md
+// seq 1000000 | /tmp/line_reader /dev/stdin
+int main(const int argc, const char *argv[]) {
+    LineReader reader(argc > 1 ? argv[1] : "../README.md");
+
+    std::size_t lines = 0;
+    std::size_t invalid = 0;
+    std::string longest; // lines are only valid until the next one is read, keep a copy
+    for (const std::string_view line : reader) {
+        ++lines;
+        if (!utf8::isValid(line)) ++invalid;
+        if (line.size() > longest.size()) longest = line;
+    }
+
+    std::cout << std::format("{0} lines, {1} with malformed UTF-8\n", lines, invalid);
+    std::cout << std::format("Longest ({0} bytes): \"{1}\"\n", longest.size(), longest);
+    return 0;
+}
@@ -0,0 +1,288 @@
+/**
+ * line_reader
+ *
+ * Streaming line reader for files larger than RAM: bounded memory, no per-line allocation.
+ *
+ * A prefetch thread fills a few large page-aligned buffers with read() while the consumer splits the previous
+ * one into lines, so reading and processing overlap (double / triple buffering). Lines are std::string_views
+ * straight into the buffers; the one line per buffer that straddles a buffer boundary (or a line longer than a
+ * buffer) is stitched together in a separate string. Memory: bufferCount * bufferSize + the longest line.
+ *
+ * Lines are split on '\n' like std::getline: the '\n' is not included, a final newline doesn't produce
+ * an extra empty line, '\r' is kept.
+ *
+ * Usage:
+ *  LineReader reader("huge.log");
+ *  for (const std::string_view line : reader) ...       // each line valid until the next one is read
+ *
+ * io_uring would save the prefetch thread, but needs liburing; plain read() + posix_fadvise() already
+ * keeps up with the disk for sequential access. POSIX only.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+
+class LineReader {
+public:
+    struct Options {
+        std::size_t bufferSize = 4 << 20; // rounded up to a multiple of 4 KiB
+        std::size_t bufferCount = 3;      // at least 2 with prefetch
+        bool prefetch = true;             // read on a background thread
+    };
+
+    /**
+     * @param path file to read, "/dev/stdin" works too
+     * @param options buffer sizes and prefetching
+     * @throws std::system_error with errno and the path if the file can't be opened
+     */
+    explicit LineReader(const std::filesystem::path &path, const Options options) :
+        path_(path), bufferSize_((std::max<std::size_t>(options.bufferSize, 1) + alignment - 1) / alignment * alignment),
+        prefetch_(options.prefetch) {
+        const std::size_t count = prefetch_ ? std::max<std::size_t>(options.bufferCount, 2) : 1;
+        storage_.reset(static_cast<char *>(::operator new[](count * bufferSize_, std::align_val_t(alignment))));
+        for (std::size_t i = 0; i < count; ++i) free_.push_back(storage_.get() + i * bufferSize_);
+
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path.string());
+        }
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        if (prefetch_) {
+            thread_ = std::thread([this] { fill(); });
+        }
+    }
+
+    // Separate overload: GCC rejects "= {}" for a nested struct with default member initializers
+    explicit LineReader(const std::filesystem::path &path) : LineReader(path, Options{}) {}
+
+    LineReader(const LineReader &) = delete;
+    auto operator=(const LineReader &) -> LineReader & = delete;
+
+    // Note: a prefetch thread blocked in read() on a pipe delays this until the writer sends data or closes
+    ~LineReader() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        changed_.notify_all();
+        if (thread_.joinable()) thread_.join();
+        ::close(fd_);
+    }
+
+    /**
+     * Read the next line.
+     *
+     * @param line set to the line without '\n', valid until the next call
+     * @return false at the end of input
+     * @throws std::system_error if reading fails
+     */
+    auto next(std::string_view &line) -> bool {
+        while (true) {
+            if (!current_.data && !acquire()) {
+                // End of input: a last line without '\n' is still a line
+                if (!stitching_) return false;
+                stitching_ = false;
+                line = stitched_;
+                return true;
+            }
+
+            const char *start = current_.data + position_;
+            const std::size_t available = current_.size - position_;
+            if (available == 0) {
+                release();
+                continue;
+            }
+            const auto *newline = static_cast<const char *>(std::memchr(start, '\n', available));
+            if (newline) {
+                position_ += static_cast<std::size_t>(newline - start) + 1;
+                if (stitching_) {
+                    stitched_.append(start, newline);
+                    stitching_ = false;
+                    line = stitched_;
+                } else {
+                    line = {start, static_cast<std::size_t>(newline - start)};
+                }
+                return true;
+            }
+
+            // The rest of this buffer starts a line that continues in the next one
+            if (!stitching_) {
+                stitched_.clear();
+                stitching_ = true;
+            }
+            stitched_.append(start, available);
+            release();
+        }
+    }
+
+    class Iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        explicit Iterator(LineReader *reader) : reader_(reader) { ++*this; }
+
+        [[nodiscard]] auto operator*() const -> std::string_view { return line_; }
+
+        auto operator++() -> Iterator & {
+            if (!reader_->next(line_)) reader_ = nullptr;
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        [[nodiscard]] friend auto operator==(const Iterator &it, std::default_sentinel_t) noexcept -> bool {
+            return it.reader_ == nullptr;
+        }
+
+    private:
+        LineReader *reader_;
+        std::string_view line_;
+    };
+
+    // Single pass: lines already read are not repeated
+    [[nodiscard]] auto begin() -> Iterator { return Iterator(this); }
+    [[nodiscard]] auto end() const noexcept -> std::default_sentinel_t { return std::default_sentinel; }
+
+private:
+    static constexpr std::size_t alignment = 4096;
+
+    struct AlignedDelete {
+        void operator()(char *p) const noexcept { ::operator delete[](p, std::align_val_t(alignment)); }
+    };
+
+    struct Chunk {
+        char *data = nullptr;
+        std::size_t size = 0; // 0: end of input
+    };
+
+    // Read until the buffer is full or the input ends
+    auto readFull(char *buffer) -> std::size_t {
+        std::size_t size = 0;
+        while (size < bufferSize_) {
+            const ::ssize_t got = ::read(fd_, buffer + size, bufferSize_ - size);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "read " + path_.string());
+            }
+            if (got == 0) break;
+            size += static_cast<std::size_t>(got);
+        }
+        return size;
+    }
+
+    // Prefetch thread: fill free buffers in order until the end of input, an error or stop
+    void fill() {
+        while (true) {
+            char *buffer;
+            {
+                std::unique_lock lock(mutex_);
+                changed_.wait(lock, [this] { return stop_ || !free_.empty(); });
+                if (stop_) return;
+                buffer = free_.back();
+                free_.pop_back();
+            }
+
+            Chunk chunk{buffer, 0};
+            std::exception_ptr error;
+            try {
+                chunk.size = readFull(buffer);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard lock(mutex_);
+                filled_.push_back(chunk);
+                if (error) error_ = error;
+            }
+            changed_.notify_all();
+            if (chunk.size == 0) return;
+        }
+    }
+
+    // Make the next filled buffer current, false at the end of input
+    auto acquire() -> bool {
+        if (finished_) return false;
+
+        Chunk chunk;
+        if (prefetch_) {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [this] { return !filled_.empty(); });
+            chunk = filled_.front();
+            filled_.pop_front();
+            if (chunk.size == 0 && error_) {
+                finished_ = true;
+                std::rethrow_exception(error_);
+            }
+        } else {
+            chunk = {free_.back(), 0};
+            chunk.size = readFull(chunk.data);
+        }
+
+        if (chunk.size == 0) {
+            finished_ = true;
+            return false;
+        }
+        current_ = chunk;
+        position_ = 0;
+        return true;
+    }
+
+    // Hand the current buffer back to the prefetch thread
+    void release() {
+        if (prefetch_) {
+            {
+                std::lock_guard lock(mutex_);
+                free_.push_back(current_.data);
+            }
+            changed_.notify_all();
+        }
+        current_ = {};
+    }
+
+    std::filesystem::path path_;
+    std::size_t bufferSize_;
+    bool prefetch_;
+    int fd_ = -1;
+    std::unique_ptr<char[], AlignedDelete> storage_;
+
+    // Shared with the prefetch thread
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<char *> free_;
+    std::deque<Chunk> filled_;
+    std::exception_ptr error_;
+    bool stop_ = false;
+    std::thread thread_;
+
+    // Consumer side
+    Chunk current_;
+    std::size_t position_ = 0;
+    std::string stitched_;
+    bool stitching_ = false;
+    bool finished_ = false;
+};
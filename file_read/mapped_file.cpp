@@ -0,0 +1,38 @@
+/**
+ * MappedFile example: the whole file as a std::string_view, no streambuf, no copy.
+ *
+ * Compare with rdbuf.cpp, which pulls the file through std::istreambuf_iterator one char at a time
+ * into a growing std::string.
+ */
+
+
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../basics/strings.hpp"
+#include "mapped_file.hpp"
+
+// g++ -std=c++23 mapped_file.cpp -o /tmp/mapped_file && /tmp/mapped_file ../README.md
+// echo "piped 早安" | /tmp/mapped_file /dev/stdin
+int main(const int argc, const char *argv[]) {
+    const MappedFile file(argc > 1 ? argv[1] : "../README.md");
+
+    const std::vector<std::string_view> lines = splitString(file, '\n');
+    const utf8::Error error = utf8::validate(file);
+
+    std::cout << std::format(
+        "{0} bytes ({1}), {2} lines, {3}\n",
+        file.size(),
+        file.isMapped() ? "mmap" : "read() fallback",
+        lines.size(),
+        error.ok() ? std::format("{} code points", utf8::countCodePoints(file)) : std::string(utf8::describe(error.status))
+    );
+    std::cout << std::format("First line: \"{}\"\n", lines.front());
+    // A trailing newline leaves an empty last field
+    const std::string_view lastLine = lines.size() > 1 && lines.back().empty() ? lines[lines.size() - 2] : lines.back();
+    std::cout << std::format("Last line, upper case: \"{}\"\n", toUpperCase(lastLine));
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * mapped_file
+ *
+ * Read-only file contents as one contiguous std::string_view, without copying through a streambuf.
+ *
+ * Regular files are mmap'ed, with madvise() hints for the expected access pattern: the kernel reads ahead
+ * and the pages come straight from the page cache. Pipes, terminals, /proc files (size 0) and filesystems
+ * that refuse mmap fall back to a buffered read() loop into an owned buffer, so the interface is the same.
+ *
+ * Caveat: if another process truncates a mapped file, touching the missing pages raises SIGBUS.
+ *
+ * Usage:
+ *  const MappedFile file("data.csv");
+ *  for (std::string_view line : splitString(file, '\n')) ...
+ *
+ * POSIX only (Linux, macOS, BSD).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+class MappedFile {
+public:
+    enum class Access : std::uint8_t {
+        sequential, // read ahead aggressively, e.g. parsing or splitting the whole file
+        random,     // no read-ahead, e.g. lookups by offset
+        normal,     // kernel defaults
+    };
+
+    /**
+     * @param path file to read, "/dev/stdin" works too
+     * @param access expected access pattern, passed to madvise()
+     * @throws std::system_error with errno and the path if the file can't be opened or read
+     */
+    explicit MappedFile(const std::filesystem::path &path, const Access access = Access::sequential) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path.string());
+        }
+        // Closed right away: a mapping stays valid without its descriptor
+        const Descriptor guard{fd};
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fstat " + path.string());
+        }
+
+        if (S_ISREG(info.st_mode) && info.st_size > 0) {
+            const auto size = static_cast<std::size_t>(info.st_size);
+            void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                data_ = static_cast<const char *>(mapped);
+                size_ = size;
+                mapped_ = true;
+                advise(access);
+                return;
+            }
+            // e.g. ENODEV on filesystems without mmap support: read instead
+        }
+
+        readAll(fd, path, S_ISREG(info.st_mode) ? static_cast<std::size_t>(info.st_size) : 0);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+    MappedFile(MappedFile &&other) noexcept :
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        mapped_(std::exchange(other.mapped_, false)),
+        buffer_(std::move(other.buffer_)) {}
+
+    auto operator=(MappedFile &&other) noexcept -> MappedFile & {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapped_ = std::exchange(other.mapped_, false);
+            buffer_ = std::move(other.buffer_);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    [[nodiscard]] auto data() const noexcept -> const char * { return data_; }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+    [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+    // true for mmap, false for the read() fallback
+    [[nodiscard]] auto isMapped() const noexcept -> bool { return mapped_; }
+
+    [[nodiscard]] auto view() const noexcept -> std::string_view { return {data_, size_}; }
+
+    [[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte> {
+        return {reinterpret_cast<const std::byte *>(data_), size_};
+    }
+
+    // Plugs straight into everything taking a std::string_view: splitString(file, '\n'), utf8::validate(file)...
+    operator std::string_view() const noexcept { return view(); }
+
+    /**
+     * Change the access hint for a part of the file, e.g. Access::sequential for a region about to be scanned.
+     * No-op for the read() fallback.
+     */
+    void advise(const Access access, const std::size_t offset = 0, std::size_t length = SIZE_MAX) const noexcept {
+        if (!mapped_ || offset >= size_) return;
+        // madvise() wants a page-aligned start
+        static const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t start = offset / pageSize * pageSize;
+        length = std::min(length, size_ - offset) + (offset - start);
+
+        auto *address = const_cast<char *>(data_) + start;
+        switch (access) {
+            case Access::sequential:
+                ::madvise(address, length, MADV_SEQUENTIAL);
+                ::madvise(address, length, MADV_WILLNEED);
+                break;
+            case Access::random:
+                ::madvise(address, length, MADV_RANDOM);
+                break;
+            case Access::normal:
+                ::madvise(address, length, MADV_NORMAL);
+                break;
+        }
+    }
+
+private:
+    struct Descriptor {
+        int fd;
+        ~Descriptor() { ::close(fd); }
+    };
+
+    void readAll(const int fd, const std::filesystem::path &path, const std::size_t sizeHint) {
+        std::size_t capacity = std::max<std::size_t>(sizeHint + 1, 64 * 1024);
+        std::size_t size = 0;
+        buffer_ = std::make_unique_for_overwrite<char[]>(capacity);
+
+        while (true) {
+            if (size == capacity) {
+                capacity *= 2;
+                auto grown = std::make_unique_for_overwrite<char[]>(capacity);
+                std::copy_n(buffer_.get(), size, grown.get());
+                buffer_ = std::move(grown);
+            }
+            const ::ssize_t got = ::read(fd, buffer_.get() + size, capacity - size);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "read " + path.string());
+            }
+            if (got == 0) break;
+            size += static_cast<std::size_t>(got);
+        }
+
+        data_ = buffer_.get();
+        size_ = size;
+    }
+
+    void unmap() noexcept {
+        if (mapped_) {
+            ::munmap(const_cast<char *>(data_), size_);
+            mapped_ = false;
+        }
+    }
+
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::unique_ptr<char[]> buffer_; // read() fallback only
+};
@@ -3,6 +3,9 @@
  *
  * Author: Stephen Jingle <sib.li>
  * Created: 27 May 2025
+ *
+ * Simple, but the slowest way to load a file: one virtual call per char and a growing string.
+ * For large files see mapped_file.hpp
  */
 
 
@@ -0,0 +1,41 @@
+/**
+ * BatchWriter example: buffered writev() output with precise errors.
+ *
+ * Compare with fstream.cpp: std::endl flushes on every line, and a single fail() check at the end
+ * can't tell which write failed or why.
+ */
+
+
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "batch_writer.hpp"
+
+// g++ -std=c++23 batch_writer.cpp -o /tmp/batch_writer && /tmp/batch_writer
+int main() {
+    BatchWriter out("output.txt", {.durability = BatchWriter::Durability::onClose});
+    out.writeLine("Hello BatchWriter");
+    for (int i = 0; i < 3; ++i) {
+        out.writeLine(std::format("line {}", i));
+    }
+
+    // Many records in one writev(), without copying them into the buffer
+    const std::vector<std::string_view> records = {"no ", "copy ", "gather\n"};
+    out.write(records);
+    out.close();
+    std::cout << std::format("Wrote {} bytes\n", out.bytesWritten());
+
+    // Errors carry errno, path and offset: /dev/full fails every write with ENOSPC
+    try {
+        BatchWriter full("/dev/full");
+        full.writeLine("lost");
+        full.close();
+    } catch (const std::system_error &error) {
+        std::cout << std::format("Error: {}\n", error.what());
+    }
+
+    return 0;
+}
@@ -0,0 +1,282 @@
+/**
+ * batch_writer
+ *
+ * Sequential file writer for high volumes: one big user-space buffer, writev() batches, an exception with
+ * errno, path and file offset at the exact flush that failed.
+ *
+ * Compared to std::ofstream + std::endl:
+ *  - no flush per line: records are gathered in the buffer, large records are sent with it in one writev()
+ *  - short writes are retried, EINTR too; ENOSPC / EIO throw std::system_error right at that flush
+ *  - durability is explicit: nothing, fdatasync() every N bytes, or fdatasync() on close()
+ *  - optional preallocation, so running out of space shows up when the file is opened, not halfway through
+ *
+ * Call close() to see errors of the last flush: the destructor closes too, but has to swallow them
+ * (same as std::ofstream).
+ *
+ * After a failed write or fdatasync the writer is failed: the bytes the kernel took are dropped from the
+ * buffer (never written twice), later write() / flush() / sync() throw the same error again, and close()
+ * only releases the descriptor.
+ *
+ * Usage:
+ *  BatchWriter out("out.log", {.durability = BatchWriter::Durability::onClose});
+ *  out.writeLine("Hello");
+ *  out.close();
+ *
+ * POSIX only, fallocate() on Linux.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+class BatchWriter {
+public:
+    enum class Durability : std::uint8_t {
+        none,     // leave it to the kernel (data is lost on power failure, not on a crash of the process)
+        periodic, // fdatasync() every Options::syncEvery bytes and on close()
+        onClose,  // fdatasync() once, on close()
+    };
+
+    struct Options {
+        std::size_t bufferSize = 1 << 20;
+        Durability durability = Durability::none;
+        std::size_t syncEvery = 64 << 20;
+        std::size_t preallocate = 0; // bytes to reserve on disk up front, 0 for none
+        bool append = false;         // otherwise truncate
+    };
+
+    /**
+     * @param path file to create (or truncate / append to)
+     * @param options buffer size, durability, preallocation
+     * @throws std::system_error if the file can't be opened or the space can't be reserved
+     */
+    BatchWriter(const std::filesystem::path &path, const Options options) :
+        path_(path), options_(options), buffer_(std::make_unique_for_overwrite<char[]>(std::max<std::size_t>(options.bufferSize, 1))) {
+        options_.bufferSize = std::max<std::size_t>(options.bufferSize, 1);
+        const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (options.append ? O_APPEND : O_TRUNC);
+        fd_ = ::open(path.c_str(), flags, 0644);
+        if (fd_ < 0) {
+            fail("open");
+        }
+
+        if (options.append) {
+            struct stat info{};
+            if (::fstat(fd_, &info) == 0) offset_ = static_cast<std::size_t>(info.st_size);
+        }
+
+        if (options.preallocate > 0) {
+#if defined(__linux__)
+            // KEEP_SIZE: blocks are reserved, but the file size only grows with what is written
+            if (::fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset_), static_cast<off_t>(options.preallocate)) != 0 &&
+                errno != EOPNOTSUPP) {
+                const int error = errno;
+                ::close(fd_);
+                fd_ = -1;
+                throw std::system_error(error, std::generic_category(), "fallocate " + path.string());
+            }
+#endif
+        }
+    }
+
+    // Separate overload: GCC rejects "= {}" for a nested struct with default member initializers
+    explicit BatchWriter(const std::filesystem::path &path) : BatchWriter(path, Options{}) {}
+
+    BatchWriter(const BatchWriter &) = delete;
+    auto operator=(const BatchWriter &) -> BatchWriter & = delete;
+
+    ~BatchWriter() {
+        try {
+            close();
+        } catch (...) {
+            // Too late to report, call close() explicitly
+        }
+    }
+
+    /**
+     * Buffer a record. Records of at least half the buffer size are not copied:
+     * they go out together with the buffered data in a single writev().
+     *
+     * @throws std::system_error if a flush fails
+     */
+    void write(const std::string_view &record) {
+        checkFailed();
+        const std::size_t capacity = options_.bufferSize;
+        if (record.size() >= capacity / 2) {
+            iovec parts[] = {
+                {buffer_.get(), used_},
+                {const_cast<char *>(record.data()), record.size()},
+            };
+            writeAll(parts);
+            return;
+        }
+        if (used_ + record.size() > capacity) {
+            flush();
+        }
+        std::memcpy(buffer_.get() + used_, record.data(), record.size());
+        used_ += record.size();
+    }
+
+    void writeLine(const std::string_view &line) {
+        write(line);
+        write("\n");
+    }
+
+    /**
+     * Write many records with as few syscalls as possible (up to IOV_MAX records per writev()), no copying.
+     */
+    void write(const std::span<const std::string_view> records) {
+        checkFailed();
+        std::vector<iovec> parts;
+        parts.reserve(records.size() + 1);
+        parts.push_back({buffer_.get(), used_});
+        for (const std::string_view record : records) {
+            parts.push_back({const_cast<char *>(record.data()), record.size()});
+        }
+        writeAll(parts);
+    }
+
+    // Hand the buffered data to the kernel (no fdatasync)
+    void flush() {
+        checkFailed();
+        if (used_ == 0) return;
+        iovec part{buffer_.get(), used_};
+        writeAll({&part, 1});
+    }
+
+    // flush() + fdatasync(): the data is on disk when this returns
+    void sync() {
+        flush();
+        if (::fdatasync(fd_) != 0) {
+            fail("fdatasync");
+        }
+        unsynced_ = 0;
+    }
+
+    /**
+     * Flush, sync (depending on durability) and close. Safe to call twice.
+     *
+     * @throws std::system_error on the first failing step; the descriptor is closed anyway
+     */
+    void close() {
+        if (fd_ < 0) return;
+        if (error_ != 0) {
+            // Already reported, and retrying could write what the kernel took before the error a second time
+            ::close(fd_);
+            fd_ = -1;
+            return;
+        }
+        try {
+            if (options_.durability == Durability::none) {
+                flush();
+            } else {
+                sync();
+            }
+        } catch (...) {
+            ::close(fd_);
+            fd_ = -1;
+            throw;
+        }
+        const int fd = fd_;
+        fd_ = -1;
+        // close() can report delayed write errors, e.g. on NFS
+        if (::close(fd) != 0) {
+            fail("close");
+        }
+    }
+
+    // Bytes handed to the kernel so far (file offset)
+    [[nodiscard]] auto bytesWritten() const noexcept -> std::size_t { return offset_; }
+
+    [[nodiscard]] auto buffered() const noexcept -> std::size_t { return used_; }
+
+    [[nodiscard]] auto failed() const noexcept -> bool { return error_ != 0; }
+
+private:
+    // Throw, and mark the writer failed once the file is open
+    [[noreturn]] void fail(const char *operation, const int error = errno) {
+        if (fd_ >= 0) error_ = error;
+        throw std::system_error(error, std::generic_category(),
+                                std::string(operation) + " " + path_.string() + " at offset " + std::to_string(offset_));
+    }
+
+    void checkFailed() const {
+        if (error_ != 0) {
+            throw std::system_error(error_, std::generic_category(), "write " + path_.string() + " after an earlier error");
+        }
+    }
+
+    /**
+     * writev() everything, retrying short writes and EINTR. parts[0] is the buffer: it is empty when this
+     * returns, or on failure holds only the bytes the kernel didn't take.
+     */
+    void writeAll(std::span<iovec> parts) {
+        std::size_t total = 0;
+        const auto dropWritten = [&] {
+            const std::size_t done = std::min(total, used_);
+            std::memmove(buffer_.get(), buffer_.get() + done, used_ - done);
+            used_ -= done;
+        };
+        while (!parts.empty() && parts.front().iov_len == 0) parts = parts.subspan(1);
+
+        while (!parts.empty()) {
+            const int count = static_cast<int>(std::min<std::size_t>(parts.size(), IOV_MAX));
+            const ::ssize_t written = ::writev(fd_, parts.data(), count);
+            if (written <= 0) {
+                if (written < 0 && errno == EINTR) continue;
+                // 0 bytes with data left: no progress is possible, don't spin
+                const int error = written < 0 ? errno : EIO;
+                dropWritten();
+                fail("write", error);
+            }
+            auto rest = static_cast<std::size_t>(written);
+            offset_ += rest;
+            total += rest;
+
+            // Skip what was written, resume in the middle of a partly written record
+            while (!parts.empty() && rest >= parts.front().iov_len) {
+                rest -= parts.front().iov_len;
+                parts = parts.subspan(1);
+            }
+            if (!parts.empty()) {
+                parts.front().iov_base = static_cast<char *>(parts.front().iov_base) + rest;
+                parts.front().iov_len -= rest;
+            }
+        }
+
+        used_ = 0;
+        unsynced_ += total;
+        if (options_.durability == Durability::periodic && unsynced_ >= options_.syncEvery) {
+            if (::fdatasync(fd_) != 0) {
+                fail("fdatasync");
+            }
+            unsynced_ = 0;
+        }
+    }
+
+    std::filesystem::path path_;
+    Options options_;
+    std::unique_ptr<char[]> buffer_;
+    std::size_t used_ = 0;
+    std::size_t offset_ = 0;
+    std::size_t unsynced_ = 0;
+    int error_ = 0; // errno of the failure that put the writer in the failed state
+    int fd_ = -1;
+};
@@ -0,0 +1,16 @@
+#include "checked_stdout.hpp"
+
+// g++ -std=c++20 checked_stdout.cpp -o checked_stdout
+// ./checked_stdout > /dev/full; echo $?
+int main() {
+    auto &out = checkedStdout();
+
+    out.println("Hello {}", "checked stdout");
+    for (int i = 0; i < 3; ++i) {
+        out.println("line {}", i);
+    }
+
+    // Buffered output is written and checked at exit:
+    // failed printing to stdout: No space left on device (os error 28), exit status 1
+    return 0;
+}
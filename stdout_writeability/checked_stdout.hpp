@@ -0,0 +1,166 @@
+/**
+ * checked_stdout
+ *
+ * Buffered output straight to a file descriptor that notices when the output can't be written.
+ *
+ * printf / std::cout / std::println keep going on ENOSPC or EPIPE (see readme.md). Checking fail() after
+ * every line means flushing every line, which is slow for large outputs. CheckedOutput instead:
+ *  - formats into one big buffer, no iostream / stdio locking or sync_with_stdio overhead
+ *  - write()s the buffer when it's full, checking every result, retrying short writes and EINTR
+ *  - reports the first error at that batch boundary: throws std::system_error, or calls your handler
+ *  - at exit (destructor), reports like Rust does and exits with a failure status:
+ *      failed printing to stdout: No space left on device (os error 28)
+ * After an error, further output is discarded.
+ *
+ * EPIPE (reader went away) only shows up with SIGPIPE ignored, otherwise the signal ends the process first.
+ *
+ * Don't mix with std::cout / printf on the same descriptor without flushing both, the order is not kept.
+ *
+ * Usage:
+ *  auto &out = checkedStdout();
+ *  out.println("Hello {}", "checked");
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+
+
+class CheckedOutput {
+public:
+    using ErrorHandler = std::function<void(const std::error_code &)>;
+
+    struct Options {
+        std::size_t bufferSize = 64 * 1024;
+        // Called once, with the first error. Empty: throw std::system_error from the call that failed
+        ErrorHandler onError;
+        // For error messages
+        std::string name = "stdout";
+    };
+
+    explicit CheckedOutput(const int fd, Options options) : fd_(fd), options_(std::move(options)) {
+        buffer_.reserve(options_.bufferSize + 256);
+    }
+
+    // Separate overload: GCC rejects "= {}" for a nested struct with default member initializers
+    explicit CheckedOutput(const int fd = STDOUT_FILENO) : CheckedOutput(fd, Options{}) {}
+
+    CheckedOutput(const CheckedOutput &) = delete;
+    auto operator=(const CheckedOutput &) -> CheckedOutput & = delete;
+
+    // Last flush: the error goes to the handler, or without one, to stderr and the process exits with EXIT_FAILURE
+    ~CheckedOutput() {
+        if (error_) return;
+        writeBuffer();
+        if (!error_) return;
+        if (options_.onError) {
+            options_.onError(error_); // must not throw here
+        } else {
+            const std::string message = "failed printing to " + options_.name + ": " + error_.message() +
+                                        " (os error " + std::to_string(error_.value()) + ")\n";
+            [[maybe_unused]] const auto ignored = ::write(STDERR_FILENO, message.data(), message.size());
+            std::_Exit(EXIT_FAILURE);
+        }
+    }
+
+    void write(const std::string_view &text) {
+        if (error_) return;
+        buffer_.append(text);
+        flushIfFull();
+    }
+
+    void put(const char c) {
+        if (error_) return;
+        buffer_.push_back(c);
+        flushIfFull();
+    }
+
+    template<typename... Args>
+    void print(const std::format_string<Args...> format, Args &&...args) {
+        if (error_) return;
+        std::format_to(std::back_inserter(buffer_), format, std::forward<Args>(args)...);
+        flushIfFull();
+    }
+
+    template<typename... Args>
+    void println(const std::format_string<Args...> format, Args &&...args) {
+        if (error_) return;
+        std::format_to(std::back_inserter(buffer_), format, std::forward<Args>(args)...);
+        buffer_.push_back('\n');
+        flushIfFull();
+    }
+
+    /**
+     * Write everything buffered so far.
+     *
+     * @throws std::system_error on the first failure, unless an error handler is set
+     */
+    void flush() {
+        if (error_) return;
+        writeBuffer();
+        if (error_) report();
+    }
+
+    [[nodiscard]] auto ok() const noexcept -> bool { return !error_; }
+
+    // First error, or an empty error_code
+    [[nodiscard]] auto error() const noexcept -> std::error_code { return error_; }
+
+private:
+    void flushIfFull() {
+        if (buffer_.size() >= options_.bufferSize) flush();
+    }
+
+    void writeBuffer() {
+        const char *p = buffer_.data();
+        std::size_t left = buffer_.size();
+        while (left > 0) {
+            const ::ssize_t written = ::write(fd_, p, left);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                error_ = std::error_code(errno, std::generic_category());
+                break;
+            }
+            if (written == 0) {
+                // No progress with data left: an error rather than a busy loop (also at exit)
+                error_ = std::error_code(EIO, std::generic_category());
+                break;
+            }
+            p += written;
+            left -= static_cast<std::size_t>(written);
+        }
+        buffer_.clear();
+    }
+
+    void report() {
+        if (options_.onError) {
+            options_.onError(error_);
+        } else {
+            throw std::system_error(error_, "failed printing to " + options_.name);
+        }
+    }
+
+    int fd_;
+    Options options_;
+    std::string buffer_;
+    std::error_code error_;
+};
+
+
+// Process-wide checked stdout, flushed (and checked) at exit
+[[nodiscard]] inline auto checkedStdout() -> CheckedOutput & {
+    static CheckedOutput out(STDOUT_FILENO);
+    return out;
+}
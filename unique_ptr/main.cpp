@@ -1,5 +1,8 @@
 #include <iostream>
 #include <memory>
+#include <string>
+
+#include "pool.hpp"
 
 class Resource {
 public:
@@ -16,8 +19,9 @@ private:
     std::string name_;
 };
 
-// Function that takes ownership of a Resource
-void processResource(std::unique_ptr<Resource> res) {
+// Function that takes ownership of a Resource, allocated with new (std::default_delete) or from a pool::ObjectPool
+template<typename Deleter>
+void processResource(std::unique_ptr<Resource, Deleter> res) {
     if (res) {
         std::cout << "Processing the resource...\n";
         res->use();
@@ -33,7 +37,7 @@ void inspectResource(const Resource& res) {
     res.use();
 }
 
-// g++ -std=c++11 main.cpp -o /tmp/smart_pointers && /tmp/smart_pointers
+// g++ -std=c++20 main.cpp -o /tmp/smart_pointers && /tmp/smart_pointers
 int main() {
     // Create a unique_ptr owning a Resource
     std::unique_ptr<Resource> myResource(new Resource("File"));
@@ -51,5 +55,14 @@ int main() {
         anotherResource->use();             // anotherResource still owns the object
     }
 
+    // Same ownership rules with a pool: the deleter destroys the Resource and keeps its memory for the next one
+    pool::ObjectPool<Resource> resources;
+    pool::Ptr<Resource> pooledResource = resources.make("Socket");
+    processResource(std::move(pooledResource));
+    std::cout << "After processResource, pooledResource is " << (pooledResource ? "not null" : "null") << "\n";
+    // Constructed in the slot the socket was released from
+    pool::Ptr<Resource> reused = resources.make("Socket 2");
+    reused->use();
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+/**
+ * pool
+ *
+ * Typed object pool for short-lived objects created and destroyed at high rates: pool::Ptr<T> is a
+ * std::unique_ptr<T, pool::Recycle<T>> whose deleter destroys the object and gives its memory back to the pool
+ * instead of freeing it. Moving it, passing it by value to take ownership, reset() and release() work as
+ * with std::unique_ptr<T>, and it's the size of one pointer.
+ *
+ *  - each thread has its own cache of free slots: make() and the deleter on the same thread are a few
+ *    loads and stores, no atomic operation and no lock
+ *  - an object destroyed on another thread is pushed to a lock-free list of its cache (one CAS), the
+ *    owning thread takes the whole list back in one exchange when its own free list runs out
+ *  - slots are carved from blocks of 32 to 4096 objects; the memory is given back to the system when the
+ *    pool is destroyed (and the threads that used it have exited), not when objects are destroyed
+ *  - the cache of an exiting thread is handed to the next thread that uses the pool, with its free slots
+ *
+ * The pool must outlive its objects.
+ *
+ * Usage:
+ *  pool::ObjectPool<Resource> resources;
+ *  pool::Ptr<Resource> resource = resources.make("File");
+ *  processResource(std::move(resource));  // destroyed there, its slot is reused by the next make()
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+namespace pool {
+
+    template<typename T>
+    class ObjectPool;
+
+    namespace detail {
+
+        // A distinct address per thread, cheaper to get than std::this_thread::get_id()
+        [[nodiscard]] inline auto threadTag() noexcept -> const void * {
+            thread_local const char tag = 0;
+            return &tag;
+        }
+
+        template<typename T>
+        struct Cache;
+
+        // The object is the first member: a T* converts back to its slot
+        template<typename T>
+        struct Slot {
+            alignas(T) std::byte storage[sizeof(T)];
+            Cache<T> *owner;
+            Slot *next;
+        };
+
+        template<typename T>
+        struct Cache {
+            std::atomic<const void *> thread{nullptr};  // threadTag() of the owner, nullptr while orphaned
+            Slot<T> *free = nullptr;                     // owner only
+            std::atomic<Slot<T> *> remote{nullptr};      // pushed by other threads, taken all at once by the owner
+            std::size_t nextBlockSize = 32;              // owner only
+        };
+
+        // What the thread-local caches keep alive: it may outlive the ObjectPool until the threads exit
+        template<typename T>
+        struct Shared {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Cache<T>>> caches;
+            std::vector<Cache<T> *> orphans;
+            std::vector<std::unique_ptr<Slot<T>[]>> blocks;
+            std::atomic<bool> closed{false};
+
+            [[nodiscard]] auto adopt() -> Cache<T> * {
+                const std::lock_guard lock(mutex);
+                Cache<T> *cache = nullptr;
+                if (orphans.empty()) {
+                    cache = caches.emplace_back(std::make_unique<Cache<T>>()).get();
+                } else {
+                    cache = orphans.back();
+                    orphans.pop_back();
+                }
+                cache->thread.store(threadTag(), std::memory_order_relaxed);
+                return cache;
+            }
+
+            void orphan(Cache<T> *cache) {
+                const std::lock_guard lock(mutex);
+                cache->thread.store(nullptr, std::memory_order_relaxed);
+                orphans.push_back(cache);
+            }
+
+            [[nodiscard]] auto allocateBlock(const std::size_t size) -> Slot<T> * {
+                auto block = std::make_unique_for_overwrite<Slot<T>[]>(size);
+                const std::lock_guard lock(mutex);
+                return blocks.emplace_back(std::move(block)).get();
+            }
+        };
+
+        // The caches of one thread, one per pool it used; given back when the thread exits
+        template<typename T>
+        struct ThreadCaches {
+            std::vector<std::pair<std::shared_ptr<Shared<T>>, Cache<T> *>> entries;
+
+            ~ThreadCaches() {
+                for (auto &[shared, cache] : entries) shared->orphan(cache);
+            }
+
+            [[nodiscard]] auto find(const std::shared_ptr<Shared<T>> &shared) -> Cache<T> * {
+                for (const auto &[entry, cache] : entries) {
+                    if (entry == shared) return cache;
+                }
+                // First use of this pool on this thread: forget the pools destroyed since
+                std::erase_if(entries, [](const auto &entry) {
+                    if (!entry.first->closed.load(std::memory_order_relaxed)) return false;
+                    entry.first->orphan(entry.second);
+                    return true;
+                });
+                return entries.emplace_back(shared, shared->adopt()).second;
+            }
+        };
+
+    }
+
+
+    /**
+     * Deleter of pool::Ptr: destroys the object and puts its slot on the free list of the thread that
+     * allocated it. Stateless, the slot knows its cache.
+     */
+    template<typename T>
+    struct Recycle {
+        void operator()(T *object) const noexcept {
+            object->~T();
+            auto *slot = reinterpret_cast<detail::Slot<T> *>(object);
+            detail::Cache<T> *owner = slot->owner;
+            if (owner->thread.load(std::memory_order_relaxed) == detail::threadTag()) {
+                slot->next = owner->free;
+                owner->free = slot;
+                return;
+            }
+            // Treiber stack push; no ABA issue, the owner never pops single slots from it
+            detail::Slot<T> *head = owner->remote.load(std::memory_order_relaxed);
+            do {
+                slot->next = head;
+            } while (!owner->remote.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+        }
+    };
+
+    template<typename T>
+    using Ptr = std::unique_ptr<T, Recycle<T>>;
+
+
+    template<typename T>
+    class ObjectPool {
+    public:
+        ObjectPool() : shared_(std::make_shared<detail::Shared<T>>()) {}
+
+        ~ObjectPool() { shared_->closed.store(true, std::memory_order_relaxed); }
+
+        ObjectPool(const ObjectPool &) = delete;
+        ObjectPool &operator=(const ObjectPool &) = delete;
+
+        /**
+         * Construct a T in a free slot, like std::make_unique<T>.
+         *
+         * @param args constructor arguments
+         * @return owner of the new object, destroying it recycles the slot
+         * @throws whatever the constructor of T throws, the slot is kept free
+         * @throws std::bad_alloc if a new block of slots can't be allocated
+         */
+        template<typename... Args>
+        [[nodiscard]] auto make(Args &&...args) -> Ptr<T> {
+            detail::Cache<T> *cache = localCache();
+            detail::Slot<T> *slot = cache->free;
+            if (slot == nullptr) slot = refill(cache);
+            cache->free = slot->next;
+            try {
+                return Ptr<T>(::new (static_cast<void *>(slot->storage)) T(std::forward<Args>(args)...));
+            } catch (...) {
+                slot->next = cache->free;
+                cache->free = slot;
+                throw;
+            }
+        }
+
+    private:
+        [[nodiscard]] auto localCache() -> detail::Cache<T> * {
+            thread_local detail::ThreadCaches<T> caches;
+            return caches.find(shared_);
+        }
+
+        // The free list is empty: take the slots freed by other threads, or carve a new block
+        [[nodiscard]] auto refill(detail::Cache<T> *cache) -> detail::Slot<T> * {
+            detail::Slot<T> *slots = cache->remote.exchange(nullptr, std::memory_order_acquire);
+            if (slots != nullptr) return cache->free = slots;
+
+            const std::size_t size = cache->nextBlockSize;
+            cache->nextBlockSize = std::min<std::size_t>(size * 2, 4096);
+            detail::Slot<T> *block = shared_->allocateBlock(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                block[i].owner = cache;
+                block[i].next = i + 1 < size ? &block[i + 1] : nullptr;
+            }
+            return cache->free = block;
+        }
+
+        std::shared_ptr<detail::Shared<T>> shared_;
+    };
+
+}